@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+#ifdef SUBCHAT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SUBCHAT_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// Sequential source of raw input bytes, possibly decoded on the way.
+class ByteReader {
+public:
+    virtual ~ByteReader() = default;
+
+    // Reads up to 'size' bytes into dst. Returns 0 at the end of the input or after an error.
+    virtual size_t read(char *dst, size_t size) = 0;
+
+    bool failed() const {
+        return failed_;
+    }
+
+protected:
+    bool failed_ = false;
+};
+
+// Path that stands for standard input (as -i) or standard output (as -o).
+inline bool isStdio(const std::filesystem::path &path) {
+    return path == "-";
+}
+
+// Raw bytes of a file, or of standard input for "-". The first bytes can be looked at with
+// peek() before they are read, which is how compressed standard input is recognized.
+class FileReader : public ByteReader {
+public:
+    explicit FileReader(const std::filesystem::path &path)
+        : file_(isStdio(path) ? stdin : std::fopen(path.string().c_str(), "rb")), owned_(!isStdio(path)) {
+        failed_ = file_ == nullptr;
+#if defined(_WIN32)
+        if (!owned_) _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    }
+
+    ~FileReader() override {
+        if (file_ && owned_) std::fclose(file_);
+    }
+
+    // Returns up to 'size' bytes from the start of the input without consuming them.
+    // Only valid before the first read().
+    std::string_view peek(size_t size) {
+        if (file_ && peeked_.size() < size) {
+            const size_t have = peeked_.size();
+            peeked_.resize(size);
+            peeked_.resize(have + std::fread(peeked_.data() + have, 1, size - have, file_));
+        }
+        return std::string_view(peeked_.data(), std::min(size, peeked_.size()));
+    }
+
+    size_t read(char *dst, size_t size) override {
+        if (!file_) return 0;
+        if (peekPos_ < peeked_.size()) {
+            const size_t n = std::min(size, peeked_.size() - peekPos_);
+            std::memcpy(dst, peeked_.data() + peekPos_, n);
+            peekPos_ += n;
+            return n;
+        }
+        const size_t n = std::fread(dst, 1, size, file_);
+        if (n == 0 && std::ferror(file_)) {
+            std::cerr << "Error: Failed to read input\n";
+            failed_ = true;
+        }
+        return n;
+    }
+
+private:
+    std::FILE *file_;
+    bool owned_;
+    std::vector<char> peeked_;
+    size_t peekPos_ = 0;
+};
+
+#ifdef SUBCHAT_HAVE_ZLIB
+// gzip stream, including concatenated members.
+class GzipReader : public ByteReader {
+public:
+    explicit GzipReader(std::unique_ptr<ByteReader> source) : source_(std::move(source)), in_(1 << 20) {
+        // 16 + MAX_WBITS: expect a gzip header and trailer.
+        failed_ = inflateInit2(&stream_, 16 + MAX_WBITS) != Z_OK;
+        initialized_ = !failed_;
+    }
+
+    ~GzipReader() override {
+        if (initialized_) inflateEnd(&stream_);
+    }
+
+    size_t read(char *dst, size_t size) override {
+        if (failed_) return 0;
+        stream_.next_out = reinterpret_cast<Bytef *>(dst);
+        stream_.avail_out = static_cast<uInt>(std::min<size_t>(size, 1u << 30));
+        const uInt capacity = stream_.avail_out;
+        while (stream_.avail_out == capacity) {
+            if (stream_.avail_in == 0) {
+                const size_t n = source_->read(in_.data(), in_.size());
+                if (n == 0) {
+                    if (source_->failed()) {
+                        failed_ = true;
+                    } else if (inMember_) {
+                        std::cerr << "Error: Truncated gzip input\n";
+                        failed_ = true;
+                    }
+                    return 0;
+                }
+                stream_.next_in = reinterpret_cast<Bytef *>(in_.data());
+                stream_.avail_in = static_cast<uInt>(n);
+            }
+            const int ret = inflate(&stream_, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                // Another member may follow.
+                inflateReset(&stream_);
+                inMember_ = false;
+            } else if (ret == Z_OK || ret == Z_BUF_ERROR) {
+                inMember_ = true;
+            } else {
+                std::cerr << "Error: Failed to decompress gzip input: " << (stream_.msg ? stream_.msg : "corrupt data")
+                        << "\n";
+                failed_ = true;
+                return 0;
+            }
+        }
+        return capacity - stream_.avail_out;
+    }
+
+private:
+    std::unique_ptr<ByteReader> source_;
+    std::vector<char> in_;
+    z_stream stream_{};
+    bool initialized_ = false;
+    bool inMember_ = false;
+};
+#endif
+
+#ifdef SUBCHAT_HAVE_ZSTD
+// zstd stream, including concatenated frames.
+class ZstdReader : public ByteReader {
+public:
+    explicit ZstdReader(std::unique_ptr<ByteReader> source)
+        : source_(std::move(source)), stream_(ZSTD_createDStream()), in_(ZSTD_DStreamInSize()) {
+        failed_ = stream_ == nullptr;
+    }
+
+    ~ZstdReader() override {
+        ZSTD_freeDStream(stream_);
+    }
+
+    size_t read(char *dst, size_t size) override {
+        if (failed_) return 0;
+        ZSTD_outBuffer output{dst, size, 0};
+        while (output.pos == 0) {
+            if (input_.pos == input_.size) {
+                const size_t n = source_->read(in_.data(), in_.size());
+                if (n == 0) {
+                    if (source_->failed()) {
+                        failed_ = true;
+                    } else if (frameRemaining_ != 0) {
+                        std::cerr << "Error: Truncated zstd input\n";
+                        failed_ = true;
+                    }
+                    return 0;
+                }
+                input_ = {in_.data(), n, 0};
+            }
+            frameRemaining_ = ZSTD_decompressStream(stream_, &output, &input_);
+            if (ZSTD_isError(frameRemaining_)) {
+                std::cerr << "Error: Failed to decompress zstd input: " << ZSTD_getErrorName(frameRemaining_) << "\n";
+                failed_ = true;
+                return 0;
+            }
+        }
+        return output.pos;
+    }
+
+private:
+    std::unique_ptr<ByteReader> source_;
+    ZSTD_DStream *stream_;
+    std::vector<char> in_;
+    ZSTD_inBuffer input_{nullptr, 0, 0};
+    size_t frameRemaining_ = 0;
+};
+#endif
+
+enum class InputCompression {
+    None, Gzip, Zstd
+};
+
+// Detects compressed input by its magic bytes rather than its extension.
+inline InputCompression detectCompression(std::string_view magic) {
+    if (magic.size() >= 2 && magic.starts_with("\x1F\x8B")) return InputCompression::Gzip;
+    if (magic.size() >= 4 && magic.starts_with("\x28\xB5\x2F\xFD")) return InputCompression::Zstd;
+    return InputCompression::None;
+}
+
+inline InputCompression detectCompression(const std::filesystem::path &path) {
+    char magic[4] = {};
+    std::FILE *file = std::fopen(path.string().c_str(), "rb");
+    if (!file) return InputCompression::None;
+    const size_t n = std::fread(magic, 1, sizeof(magic), file);
+    std::fclose(file);
+    return detectCompression(std::string_view(magic, n));
+}
+
+// Opens 'path' ("-" for standard input) with the decoder matching its contents.
+// Returns nullptr if the file cannot be opened or this build lacks the needed decoder.
+inline std::unique_ptr<ByteReader> openByteReader(const std::filesystem::path &path) {
+    auto file = std::make_unique<FileReader>(path);
+    if (file->failed()) return nullptr;
+    std::unique_ptr<ByteReader> reader;
+    switch (detectCompression(file->peek(4))) {
+        case InputCompression::None:
+            reader = std::move(file);
+            break;
+        case InputCompression::Gzip:
+#ifdef SUBCHAT_HAVE_ZLIB
+            reader = std::make_unique<GzipReader>(std::move(file));
+#else
+            std::cerr << "Error: " << path << " is gzip-compressed, but this build has no zlib support\n";
+            return nullptr;
+#endif
+            break;
+        case InputCompression::Zstd:
+#ifdef SUBCHAT_HAVE_ZSTD
+            reader = std::make_unique<ZstdReader>(std::move(file));
+#else
+            std::cerr << "Error: " << path << " is zstd-compressed, but this build has no zstd support\n";
+            return nullptr;
+#endif
+            break;
+    }
+    if (reader->failed()) return nullptr;
+    return reader;
+}
+
+// Runs a ByteReader on its own thread, filling a small ring of blocks ahead of the consumer,
+// so decompression overlaps with parsing instead of alternating with it.
+class BlockPrefetcher {
+public:
+    explicit BlockPrefetcher(std::unique_ptr<ByteReader> reader, size_t blockCount = 4, size_t blockSize = 1 << 20)
+        : reader_(std::move(reader)), blocks_(blockCount), blockSize_(blockSize) {
+        for (auto &block: blocks_) block.data = std::make_unique_for_overwrite<char[]>(blockSize_);
+        thread_ = std::jthread([this] { run(); });
+    }
+
+    ~BlockPrefetcher() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    BlockPrefetcher(const BlockPrefetcher &) = delete;
+    BlockPrefetcher &operator=(const BlockPrefetcher &) = delete;
+
+    // Returns the next block of input, or an empty view once the input is exhausted.
+    // The block stays valid until release().
+    std::string_view acquire() {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return filled_ > 0 || done_; });
+        if (filled_ == 0) return {};
+        const Block &block = blocks_[head_];
+        return {block.data.get(), block.size};
+    }
+
+    // Hands the block returned by acquire() back to the decoding thread.
+    void release() {
+        {
+            std::lock_guard lock(mutex_);
+            head_ = (head_ + 1) % blocks_.size();
+            --filled_;
+        }
+        cv_.notify_all();
+    }
+
+    // Whether the underlying reader hit an error. Only meaningful once acquire() returned an empty view.
+    bool failed() const {
+        return reader_->failed();
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    void run() {
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || filled_ < blocks_.size(); });
+                if (stop_) return;
+            }
+            // The consumer never touches blocks that are not filled yet, so no lock is needed here.
+            Block &block = blocks_[tail_];
+            size_t size = 0;
+            while (size < blockSize_) {
+                const size_t n = reader_->read(block.data.get() + size, blockSize_ - size);
+                if (n == 0) break;
+                size += n;
+            }
+            const bool last = size < blockSize_;
+            {
+                std::lock_guard lock(mutex_);
+                block.size = size;
+                if (size > 0) {
+                    tail_ = (tail_ + 1) % blocks_.size();
+                    ++filled_;
+                }
+                done_ = last;
+            }
+            cv_.notify_all();
+            if (last) return;
+        }
+    }
+
+    std::unique_ptr<ByteReader> reader_;
+    std::vector<Block> blocks_;
+    size_t blockSize_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    size_t filled_ = 0;
+    bool done_ = false;
+    bool stop_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::jthread thread_; // Declared last, so it is joined before the blocks and the reader go away
+};
+
+// Growing window over the output of a BlockPrefetcher, for parsers that work on contiguous text.
+// Data before pos() has been consumed; refill() drops it and appends the next block, so
+// positions (and views into view()) are invalidated by refill().
+class InputWindow {
+public:
+    explicit InputWindow(std::unique_ptr<ByteReader> reader) : prefetcher_(std::move(reader)) {
+    }
+
+    std::string_view view() const {
+        return window_;
+    }
+
+    size_t pos() const {
+        return pos_;
+    }
+
+    void setPos(size_t pos) {
+        pos_ = pos;
+    }
+
+    // True once all input has been appended to the window.
+    bool eof() const {
+        return eof_;
+    }
+
+    bool failed() const {
+        return eof_ && prefetcher_.failed();
+    }
+
+    // Drops the consumed part of the window and appends the next block of input.
+    // Returns false if there was nothing left to append.
+    bool refill() {
+        window_.erase(0, pos_);
+        pos_ = 0;
+        if (eof_) return false;
+        const std::string_view block = prefetcher_.acquire();
+        if (block.empty()) {
+            eof_ = true;
+            return false;
+        }
+        window_.append(block);
+        prefetcher_.release();
+        return true;
+    }
+
+    // Returns the next line without its line terminator, refilling the window as needed.
+    // The last line does not need a trailing newline. The view is valid until the next call.
+    bool nextLine(std::string_view &line) {
+        while (true) {
+            const size_t end = window_.find('\n', pos_);
+            if (end != std::string::npos || (eof_ && pos_ < window_.size())) {
+                const size_t stop = end != std::string::npos ? end : window_.size();
+                line = std::string_view(window_).substr(pos_, stop - pos_);
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                pos_ = end != std::string::npos ? end + 1 : stop;
+                return true;
+            }
+            if (!refill()) return false;
+        }
+    }
+
+private:
+    BlockPrefetcher prefetcher_;
+    std::string window_;
+    size_t pos_ = 0;
+    bool eof_ = false;
+};
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "mapped_file.h"
+#include "ytt_generator.h"
+
+// Binary cache of a parsed chat log (.scc), so later runs skip parsing entirely.
+//
+// Layout, native byte order, every section 8-byte aligned:
+//   SccHeader
+//   char     text[textSize]               message texts and usernames, back to back
+//   uint64_t times[messageCount]          milliseconds
+//   uint32_t users[messageCount]          index into the user table
+//   uint32_t textLengths[messageCount]
+//   uint64_t textOffsets[messageCount]    message i is text[textOffsets[i], +textLengths[i])
+//   SccUser  userTable[userCount]
+// The text comes first so it can be streamed to disk while the columns are collected in
+// temporary files.
+
+inline constexpr char sccMagic[4] = {'S', 'C', 'C', '1'};
+inline constexpr uint32_t sccVersion = 1;
+inline constexpr uint32_t sccByteOrder = 0x01020304;
+
+// What the cache was built from. A cache is only used when all of it matches the current run.
+struct SccKey {
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    uint32_t format = 0;
+    int32_t timeMultiplier = 0;
+
+    bool operator==(const SccKey &) const = default;
+};
+
+struct SccHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    SccKey key;
+    uint64_t messageCount;
+    uint64_t userCount;
+    uint64_t textSize;
+};
+
+struct SccUser {
+    uint64_t nameOffset;
+    uint32_t nameLength;
+    uint8_t r, g, b, a;
+};
+
+static_assert(sizeof(SccHeader) == 64 && sizeof(SccUser) == 16);
+
+inline uint64_t sccAlign(uint64_t n) {
+    return (n + 7) & ~uint64_t{7};
+}
+
+// Returns the key describing 'source' as it is on disk now, or false if it cannot be inspected.
+inline bool sccKeyFor(const std::filesystem::path &source, uint32_t format, int timeMultiplier, SccKey &key) {
+    std::error_code ec;
+    key.sourceSize = std::filesystem::file_size(source, ec);
+    if (ec) return false;
+    const auto mtime = std::filesystem::last_write_time(source, ec);
+    if (ec) return false;
+    key.sourceMtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    key.format = format;
+    key.timeMultiplier = timeMultiplier;
+    return true;
+}
+
+// The cache file that belongs to 'source': source path with ".scc" appended.
+inline std::filesystem::path sccPathFor(const std::filesystem::path &source) {
+    std::filesystem::path path = source;
+    path += ".scc";
+    return path;
+}
+
+// A column of the cache collected in an anonymous temporary file while the text is written,
+// so that writing a cache takes no memory per message.
+class SccColumn {
+public:
+    SccColumn() : file_(std::tmpfile()) {
+        buffer_.reserve(bufferSize);
+    }
+
+    SccColumn(const SccColumn &) = delete;
+    SccColumn &operator=(const SccColumn &) = delete;
+
+    ~SccColumn() {
+        if (file_) std::fclose(file_);
+    }
+
+    template<typename T>
+    bool append(const T &value) {
+        if (buffer_.size() + sizeof(T) > bufferSize && !flush()) return false;
+        const auto *bytes = reinterpret_cast<const char *>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+        size_ += sizeof(T);
+        return true;
+    }
+
+    // Size in bytes.
+    uint64_t size() const {
+        return size_;
+    }
+
+    // Appends the column to 'out'.
+    bool copyTo(std::FILE *out) {
+        if (!flush() || std::fflush(file_) != 0 || std::fseek(file_, 0, SEEK_SET) != 0) return false;
+        buffer_.resize(bufferSize);
+        for (uint64_t left = size_; left > 0;) {
+            const size_t n = std::fread(buffer_.data(), 1, std::min<uint64_t>(left, bufferSize), file_);
+            if (n == 0 || std::fwrite(buffer_.data(), 1, n, out) != n) return false;
+            left -= n;
+        }
+        buffer_.clear();
+        return true;
+    }
+
+private:
+    static constexpr size_t bufferSize = 1 << 16;
+
+    bool flush() {
+        if (!file_ || std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) return false;
+        buffer_.clear();
+        return true;
+    }
+
+    std::FILE *file_;
+    std::vector<char> buffer_;
+    uint64_t size_ = 0;
+};
+
+// Writes every message of 'source' into a cache at 'path' and rewinds the source.
+// 'users' is the table the source's user ids refer to; only users that occur are stored.
+// The file is written under a temporary name and renamed at the end, so an interrupted run
+// never leaves a truncated cache behind. Returns false (after a warning) on I/O errors.
+inline bool writeChatCache(const std::filesystem::path &path, ChatSource &source, const UserTable &users,
+                           const SccKey &key) {
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    std::FILE *out = std::fopen(tmpPath.string().c_str(), "wb");
+    if (!out) {
+        std::cerr << "Warning: Cannot write chat cache " << path << "\n";
+        return false;
+    }
+
+    SccHeader header{};
+    std::memcpy(header.magic, sccMagic, sizeof(sccMagic));
+    header.version = sccVersion;
+    header.byteOrder = sccByteOrder;
+    header.key = key;
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+
+    SccColumn times;
+    SccColumn userIds;
+    SccColumn lengths;
+    SccColumn offsets;
+    uint64_t messageCount = 0;
+    std::vector<SccUser> userTable;
+    std::vector<uint32_t> cacheIds; // Table id -> cache id
+    uint64_t textSize = 0;
+    auto appendText = [&](std::string_view text) {
+        ok = ok && std::fwrite(text.data(), 1, text.size(), out) == text.size();
+        textSize += text.size();
+    };
+
+    ChatMessage msg;
+    while (ok && source.next(msg)) {
+        if (msg.user >= cacheIds.size()) cacheIds.resize(users.size(), UserTable::none);
+        uint32_t &id = cacheIds[msg.user];
+        if (id == UserTable::none) {
+            const User &user = users[msg.user];
+            id = static_cast<uint32_t>(userTable.size());
+            userTable.push_back({textSize, static_cast<uint32_t>(user.name.size()), user.color.r(), user.color.g(),
+                                 user.color.b(), user.color.a()});
+            appendText(user.name);
+        }
+        ok = ok && times.append(msg.time) && userIds.append(id) &&
+             lengths.append(static_cast<uint32_t>(msg.message.size())) && offsets.append(textSize);
+        ++messageCount;
+        appendText(msg.message);
+    }
+    // Never cache a log that could not be read to the end.
+    ok = ok && !source.failed();
+    source.rewind();
+
+    auto writePadding = [&](size_t size) {
+        static constexpr char zeros[8] = {};
+        const size_t pad = sccAlign(size) - size;
+        ok = ok && std::fwrite(zeros, 1, pad, out) == pad;
+    };
+    auto writeColumn = [&](SccColumn &column) {
+        ok = ok && column.copyTo(out);
+        writePadding(column.size());
+    };
+    writePadding(textSize);
+    writeColumn(times);
+    writeColumn(userIds);
+    writeColumn(lengths);
+    writeColumn(offsets);
+    ok = ok && std::fwrite(userTable.data(), sizeof(SccUser), userTable.size(), out) == userTable.size();
+
+    header.messageCount = messageCount;
+    header.userCount = userTable.size();
+    header.textSize = textSize;
+    ok = ok && std::fseek(out, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, out) == 1;
+    ok = std::fclose(out) == 0 && ok;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmpPath, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(tmpPath, ec);
+        std::cerr << "Warning: Cannot write chat cache " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// A memory-mapped .scc file. Opening only checks the header; columns are read in place.
+class ChatCache {
+public:
+    // Maps the cache at 'path' if it exists and was built from a source matching 'key'.
+    bool open(const std::filesystem::path &path, const SccKey &key) {
+        file_.close();
+        if (!file_.open(path) || file_.size() < sizeof(SccHeader)) return fail();
+        SccHeader header;
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if (std::memcmp(header.magic, sccMagic, sizeof(sccMagic)) != 0 || header.version != sccVersion ||
+            header.byteOrder != sccByteOrder || !(header.key == key))
+            return fail();
+        // Bound the counts first so the section arithmetic below cannot overflow.
+        if (header.messageCount > file_.size() || header.userCount > file_.size() || header.textSize > file_.size())
+            return fail();
+
+        const uint64_t count = header.messageCount;
+        const uint64_t textStart = sizeof(SccHeader);
+        const uint64_t timesStart = textStart + sccAlign(header.textSize);
+        const uint64_t usersStart = timesStart + count * sizeof(uint64_t);
+        const uint64_t lengthsStart = usersStart + sccAlign(count * sizeof(uint32_t));
+        const uint64_t offsetsStart = lengthsStart + sccAlign(count * sizeof(uint32_t));
+        const uint64_t userTableStart = offsetsStart + count * sizeof(uint64_t);
+        const uint64_t end = userTableStart + header.userCount * sizeof(SccUser);
+        if (end != file_.size()) return fail();
+
+        const char *base = file_.data();
+        text_ = std::string_view(base + textStart, header.textSize);
+        times_ = reinterpret_cast<const uint64_t *>(base + timesStart);
+        users_ = reinterpret_cast<const uint32_t *>(base + usersStart);
+        lengths_ = reinterpret_cast<const uint32_t *>(base + lengthsStart);
+        offsets_ = reinterpret_cast<const uint64_t *>(base + offsetsStart);
+        userTable_ = reinterpret_cast<const SccUser *>(base + userTableStart);
+        count_ = count;
+        userCount_ = header.userCount;
+        return true;
+    }
+
+    size_t size() const {
+        return count_;
+    }
+
+    size_t userCount() const {
+        return userCount_;
+    }
+
+    // Reads entry 'id' of the cached user table. Returns false if it points outside the file.
+    bool user(uint32_t id, User &user) const {
+        const SccUser &u = userTable_[id];
+        if (u.nameOffset > text_.size() || u.nameLength > text_.size() - u.nameOffset) return false;
+        user.name = text_.substr(u.nameOffset, u.nameLength);
+        user.color = Color(u.r, u.g, u.b, u.a);
+        return true;
+    }
+
+    // Builds message i with msg.user set to its index in the cached user table.
+    // Returns false if the file is inconsistent, e.g. edited by hand.
+    bool message(size_t i, ChatMessage &msg) const {
+        const uint32_t id = users_[i];
+        const uint64_t begin = offsets_[i];
+        const uint64_t length = lengths_[i];
+        if (id >= userCount_ || begin > text_.size() || length > text_.size() - begin) return false;
+        msg.time = times_[i];
+        msg.user = id;
+        msg.message = text_.substr(begin, length);
+        return true;
+    }
+
+private:
+    bool fail() {
+        file_.close();
+        count_ = userCount_ = 0;
+        return false;
+    }
+
+    MappedFile file_;
+    std::string_view text_;
+    const uint64_t *times_ = nullptr;
+    const uint32_t *users_ = nullptr;
+    const uint32_t *lengths_ = nullptr;
+    const uint64_t *offsets_ = nullptr;
+    const SccUser *userTable_ = nullptr;
+    size_t count_ = 0;
+    size_t userCount_ = 0;
+};
+
+// Messages straight out of a mapped cache; nothing is parsed or copied.
+// The cached user table is added to 'users' up front, which is cheap: it holds one entry per chatter.
+class CacheChatSource : public ChatSource {
+public:
+    CacheChatSource(const ChatCache &cache, UserTable &users) : cache_(cache), ids_(cache.userCount(), UserTable::none) {
+        User user;
+        for (uint32_t i = 0; i < ids_.size(); ++i)
+            if (cache_.user(i, user)) ids_[i] = users.intern(user.name, user.color);
+    }
+
+    bool next(ChatMessage &msg) override {
+        while (pos_ < cache_.size()) {
+            if (cache_.message(pos_++, msg) && ids_[msg.user] != UserTable::none) {
+                msg.user = ids_[msg.user];
+                // The cache was written from valid text, but the file may have been changed since.
+                msg.message = repair_(msg.message);
+                return true;
+            }
+            std::cerr << "Error: Corrupt chat cache entry " << pos_ - 1 << "\n";
+        }
+        return false;
+    }
+
+    bool rewind() override {
+        pos_ = 0;
+        repair_.rewind();
+        return true;
+    }
+
+private:
+    const ChatCache &cache_;
+    std::vector<uint32_t> ids_; // Cache id -> table id
+    Utf8Repair repair_;
+    size_t pos_ = 0;
+};
@@ -0,0 +1,533 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "byte_stream.h"
+#include "csv_scanner.h"
+#include "mapped_file.h"
+#include "text_arena.h"
+#include "ytt_generator.h"
+
+// A parsed chat log. Message texts are views into the mapped input file; only
+// fields that needed unescaping get their own copy in storage. Message user ids
+// refer to 'users'.
+struct ChatLog {
+    MappedFile file;
+    TextArena storage;
+    UserTable users;
+    std::vector<ChatMessage> messages;
+
+    bool empty() const {
+        return messages.empty();
+    }
+
+    size_t size() const {
+        return messages.size();
+    }
+};
+
+inline constexpr std::string_view csvHeader = "time,user_name,user_color,message";
+
+// One field of a CSV record. Quoted fields are returned without the surrounding
+// quotes; 'escaped' is set when the text still contains doubled quotes.
+struct CsvField {
+    std::string_view text;
+    bool escaped = false;
+};
+
+// The four columns of a chat CSV record: time, user_name, user_color, message.
+struct CsvRecord {
+    CsvField fields[4];
+};
+
+inline std::string_view csvTrimCR(std::string_view s) {
+    if (!s.empty() && s.back() == '\r') s.remove_suffix(1);
+    return s;
+}
+
+// Parses the field starting at 'pos' and returns the position of the character that
+// terminated it (',' or '\n'), or the buffer size. The last column runs to the end of the line,
+// so unquoted messages may contain commas. A field is only taken as quoted if its closing quote
+// is followed by the delimiter or the end of the line; a stray quote such as in '"hi" there' or
+// an unterminated one leaves the field to be read as is, up to the delimiter or the line end.
+inline size_t csvParseField(CsvScanner &scanner, size_t pos, bool lastColumn, CsvField &field) {
+    const std::string_view buf = scanner.buffer();
+    field.escaped = false;
+    if (pos < buf.size() && buf[pos] == '"') {
+        const size_t begin = pos + 1;
+        size_t p = begin;
+        bool escaped = false;
+        while (true) {
+            p = scanner.findQuote(p);
+            if (p + 1 < buf.size() && buf[p + 1] == '"') {
+                escaped = true;
+                p += 2;
+                continue;
+            }
+            break;
+        }
+        // The closing quote, or the end of the buffer, may be followed by more input.
+        if (scanner.partial() && p + 2 >= buf.size()) {
+            field.text = buf.substr(begin);
+            return buf.size();
+        }
+        if (p < buf.size()) {
+            size_t after = p + 1;
+            if (after < buf.size() && buf[after] == '\r' && (after + 1 == buf.size() || buf[after + 1] == '\n')) ++after;
+            if (after == buf.size() || buf[after] == '\n' || (!lastColumn && buf[after] == ',')) {
+                field.text = buf.substr(begin, p - begin);
+                field.escaped = escaped;
+                return after;
+            }
+        }
+    }
+    const size_t end = lastColumn ? scanner.findLineEnd(pos) : scanner.findDelimiter(pos);
+    field.text = buf.substr(pos, end - pos);
+    if (end == buf.size() || buf[end] == '\n') field.text = csvTrimCR(field.text);
+    return end;
+}
+
+// Parses the record starting at 'pos' and advances 'pos' to the start of the next one.
+// Missing trailing columns are left empty. Returns false if the record ran into the end
+// of the buffer instead of a newline, i.e. it may continue in data not read yet.
+inline bool csvParseRecord(CsvScanner &scanner, size_t &pos, CsvRecord &record) {
+    const std::string_view buf = scanner.buffer();
+    for (int column = 0; column < 4; ++column) {
+        size_t end = csvParseField(scanner, pos, column == 3, record.fields[column]);
+        if (end >= buf.size() || buf[end] == '\n') {
+            for (int rest = column + 1; rest < 4; ++rest) record.fields[rest] = {};
+            pos = end < buf.size() ? end + 1 : buf.size();
+            return end < buf.size();
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+// Collapses doubled quotes of an escaped field into a copy owned by 'storage'.
+inline std::string_view csvUnescape(const CsvField &field, TextArena &storage) {
+    if (!field.escaped) return field.text;
+    std::string out;
+    out.reserve(field.text.size());
+    for (size_t i = 0; i < field.text.size(); ++i) {
+        out += field.text[i];
+        if (field.text[i] == '"' && i + 1 < field.text.size() && field.text[i + 1] == '"') ++i;
+    }
+    return storage.store(out);
+}
+
+// Same as above, but the unescaped copy lives in 'scratch' and is overwritten by the next call.
+inline std::string_view csvUnescape(const CsvField &field, std::string &scratch) {
+    if (!field.escaped) return field.text;
+    scratch.clear();
+    for (size_t i = 0; i < field.text.size(); ++i) {
+        scratch += field.text[i];
+        if (field.text[i] == '"' && i + 1 < field.text.size() && field.text[i + 1] == '"') ++i;
+    }
+    return scratch;
+}
+
+// Reads the time column of a record in milliseconds. Returns false if it is not a number.
+inline bool csvRecordTime(const CsvRecord &record, int timeMultiplier, uint64_t &time) {
+    std::string_view text = record.fields[0].text;
+    uint64_t value = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || ptr == text.data()) return false;
+    time = value * timeMultiplier;
+    return true;
+}
+
+// Builds a message out of a parsed record whose name and message were already unescaped.
+// Returns false if the time column is not a number.
+inline bool csvRecordToMessage(const CsvRecord &record, int timeMultiplier, UserTable &users, std::string_view name,
+                               std::string_view message, ChatMessage &msg) {
+    if (!csvRecordTime(record, timeMultiplier, msg.time)) return false;
+
+    std::string_view color = record.fields[2].text;
+    msg.user = color.empty() ? users.internDefault(name) : users.intern(name, Color(color));
+    msg.message = message;
+    return true;
+}
+
+// Same as above for a record whose name and message may still need unescaping: the name goes
+// through 'nameScratch' (the user table keeps its own copy), the message into 'storage'.
+inline bool csvRecordToMessage(const CsvRecord &record, int timeMultiplier, UserTable &users, TextArena &storage,
+                               std::string &nameScratch, ChatMessage &msg) {
+    return csvRecordToMessage(record, timeMultiplier, users, csvUnescape(record.fields[1], nameScratch),
+                              csvUnescape(record.fields[3], storage), msg);
+}
+
+// Returns the offset of the first record, or npos if the header does not match.
+inline size_t csvSkipHeader(std::string_view buf) {
+    size_t pos = 0;
+    if (buf.starts_with("\xEF\xBB\xBF")) pos = 3; // BOM
+    size_t end = buf.find('\n', pos);
+    if (end == std::string_view::npos) end = buf.size();
+    if (csvTrimCR(buf.substr(pos, end - pos)) != csvHeader) return std::string_view::npos;
+    return end < buf.size() ? end + 1 : buf.size();
+}
+
+// Messages parsed from one slice of a CSV buffer.
+struct CsvChunk {
+    size_t begin = 0; // Offset of the first record
+    size_t end = 0; // Offset where parsing stopped, the start of the next chunk's first record
+    std::vector<ChatMessage> messages;
+    TextArena storage;
+    UserTable users; // Chunk-local ids, remapped when chunks are spliced
+    size_t skipped = 0;
+    size_t repaired = 0; // Messages with invalid UTF-8 replaced
+};
+
+// Parses records from chunk.begin on, stopping before the first record that starts at or after 'limit'.
+inline void csvParseChunk(std::string_view buf, size_t limit, int timeMultiplier, CsvChunk &chunk) {
+    CsvScanner scanner(buf);
+    CsvRecord record;
+    std::string name, scratch;
+    size_t pos = chunk.begin;
+    while (pos < limit && pos < buf.size()) {
+        if (buf[pos] == '\n') {
+            ++pos;
+            continue;
+        }
+        if (buf[pos] == '\r' && pos + 1 < buf.size() && buf[pos + 1] == '\n') {
+            pos += 2;
+            continue;
+        }
+        csvParseRecord(scanner, pos, record);
+        ChatMessage msg;
+        if (!csvRecordToMessage(record, timeMultiplier, chunk.users, chunk.storage, name, msg)) {
+            ++chunk.skipped;
+            continue;
+        }
+        const std::string_view text = utf8Sanitize(msg.message, scratch);
+        if (text.data() != msg.message.data()) {
+            msg.message = chunk.storage.store(text);
+            ++chunk.repaired;
+        }
+        chunk.messages.push_back(msg);
+    }
+    chunk.end = pos;
+}
+
+// Returns the start of the first record after 'pos': the start of the first line after it that
+// parses as a whole record with a numeric time. Lines of a quoted message that spans several lines
+// rarely look like that; if one does, the chunk is parsed again (see csvParseParallel).
+inline size_t csvNextRecordStart(std::string_view buf, size_t pos, int timeMultiplier) {
+    CsvScanner scanner(buf);
+    CsvRecord record;
+    uint64_t time;
+    while (true) {
+        pos = scanner.find(pos, CsvScanner::Newline);
+        if (pos == buf.size()) return pos;
+        const size_t start = ++pos;
+        size_t next = start;
+        if (csvParseRecord(scanner, next, record) && csvRecordTime(record, timeMultiplier, time)) return start;
+    }
+}
+
+// Below this size per thread, splitting the file is not worth starting threads.
+inline constexpr size_t csvMinChunkSize = 4 * 1024 * 1024;
+
+// Parses the records in buf[begin, end) on several threads.
+// The range is cut into equal slices; each slice finds its first record on its own, by the
+// rules the parser reads records with, and the slices are parsed in parallel and spliced in
+// order. If a slice does not start exactly where the previous one stopped, which takes a quoted
+// multi-line message that looks like records, it is parsed again from there.
+inline std::vector<CsvChunk> csvParseParallel(std::string_view buf, size_t begin, int timeMultiplier, unsigned threads) {
+    const size_t size = buf.size() - begin;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t count = std::max<size_t>(1, std::min<size_t>(threads, size / csvMinChunkSize));
+
+    // Chunk i owns the records that start in (cut[i], cut[i + 1]], chunk 0 also owns the one at 'begin'.
+    std::vector<size_t> cut(count + 1);
+    for (size_t i = 0; i <= count; ++i) cut[i] = begin + size * i / count;
+    std::vector<CsvChunk> chunks(count);
+    if (count == 1) {
+        chunks[0].begin = begin;
+        csvParseChunk(buf, buf.size(), timeMultiplier, chunks[0]);
+        return chunks;
+    }
+
+    {
+        std::vector<std::jthread> workers;
+        for (size_t i = 0; i < count; ++i) {
+            workers.emplace_back([&, i] {
+                chunks[i].begin = i == 0 ? begin : csvNextRecordStart(buf, cut[i], timeMultiplier);
+                csvParseChunk(buf, cut[i + 1] + 1, timeMultiplier, chunks[i]);
+            });
+        }
+    }
+
+    size_t reparsed = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (chunks[i].begin == chunks[i - 1].end) continue;
+        chunks[i] = CsvChunk{};
+        chunks[i].begin = chunks[i - 1].end;
+        csvParseChunk(buf, cut[i + 1] + 1, timeMultiplier, chunks[i]);
+        ++reparsed;
+    }
+    if (reparsed > 0) {
+        std::cerr << "Note: Parsed " << reparsed << " of " << count
+                << " CSV chunks again on one thread; they started inside a multi-line message.\n";
+    }
+    return chunks;
+}
+
+// Parses a chat CSV without copying it: the file is mapped into memory and
+// the returned messages point straight into the mapping. Large files are
+// parsed on up to 'threads' threads (0 = one per hardware thread).
+inline ChatLog parseCSV(const std::filesystem::path &filename, int timeMultiplier, unsigned threads = 0) {
+    ChatLog log;
+    if (!log.file.open(filename)) {
+        std::cerr << "Error: Could not open file " << filename << "\n";
+        std::exit(-1);
+    }
+
+    const std::string_view buf = log.file.view();
+    size_t pos = csvSkipHeader(buf);
+    if (pos == std::string_view::npos) {
+        std::cerr << "Error: Unexpected CSV header format.\n";
+        std::exit(-1);
+    }
+
+    auto chunks = csvParseParallel(buf, pos, timeMultiplier, threads);
+    size_t total = 0;
+    size_t skipped = 0;
+    size_t repaired = 0;
+    for (const auto &chunk: chunks) {
+        total += chunk.messages.size();
+        skipped += chunk.skipped;
+        repaired += chunk.repaired;
+    }
+    log.messages.reserve(total);
+    for (auto &chunk: chunks) {
+        const std::vector<uint32_t> ids = log.users.merge(chunk.users);
+        for (ChatMessage &msg: chunk.messages) {
+            msg.user = ids[msg.user];
+            log.messages.push_back(msg);
+        }
+        chunk.messages = {};
+        chunk.users = {};
+        log.storage.splice(std::move(chunk.storage));
+    }
+    if (skipped > 0) std::cerr << "Warning: Skipped " << skipped << " malformed CSV lines.\n";
+    if (repaired > 0) std::cerr << "Warning: Replaced invalid UTF-8 in " << repaired << " messages.\n";
+
+    return log;
+}
+
+// Streams messages out of a chat CSV one record at a time. The file is mapped, so memory use
+// is bounded by the page cache rather than the number of messages.
+class CsvChatSource : public ChatSource {
+public:
+    CsvChatSource(const std::filesystem::path &filename, int timeMultiplier, UserTable &users)
+        : users_(users), timeMultiplier_(timeMultiplier) {
+        if (!file_.open(filename)) {
+            std::cerr << "Error: Could not open file " << filename << "\n";
+            std::exit(-1);
+        }
+        start_ = csvSkipHeader(file_.view());
+        if (start_ == std::string_view::npos) {
+            std::cerr << "Error: Unexpected CSV header format.\n";
+            std::exit(-1);
+        }
+        ranges_ = {{start_, file_.size()}};
+        rewind();
+    }
+
+    // Reports malformed lines of the last pass over the file.
+    ~CsvChatSource() override {
+        if (skipped_ > 0) std::cerr << "Warning: Skipped " << skipped_ << " malformed CSV lines.\n";
+    }
+
+    bool next(ChatMessage &msg) override {
+        const std::string_view buf = scanner_.buffer();
+        while (true) {
+            if (pos_ >= end_) {
+                if (++range_ >= ranges_.size()) return false;
+                pos_ = ranges_[range_].first;
+                end_ = ranges_[range_].second;
+                continue;
+            }
+            if (buf[pos_] == '\n') {
+                ++pos_;
+                continue;
+            }
+            if (buf[pos_] == '\r' && pos_ + 1 < buf.size() && buf[pos_ + 1] == '\n') {
+                pos_ += 2;
+                continue;
+            }
+            csvParseRecord(scanner_, pos_, record_);
+            if (csvRecordToMessage(record_, timeMultiplier_, users_, csvUnescape(record_.fields[1], name_),
+                                   csvUnescape(record_.fields[3], message_), msg)) {
+                msg.message = repair_(msg.message);
+                return true;
+            }
+            ++skipped_;
+        }
+    }
+
+    bool rewind() override {
+        range_ = 0;
+        pos_ = ranges_[0].first;
+        end_ = ranges_[0].second;
+        scanner_ = CsvScanner(file_.view());
+        skipped_ = 0;
+        repair_.rewind();
+        return true;
+    }
+
+    // Limits the source to the records starting inside the given [begin, end) byte ranges,
+    // e.g. the blocks of a time index that overlap a clip. Ranges must be in file order and
+    // begin at record boundaries. Rewinds the source.
+    void restrictTo(std::vector<std::pair<size_t, size_t> > ranges) {
+        ranges_ = std::move(ranges);
+        if (ranges_.empty()) ranges_.emplace_back(start_, start_);
+        rewind();
+    }
+
+    size_t dataStart() const {
+        return start_;
+    }
+
+    std::string_view buffer() const {
+        return file_.view();
+    }
+
+private:
+    MappedFile file_;
+    CsvScanner scanner_{std::string_view()};
+    CsvRecord record_;
+    UserTable &users_;
+    std::string name_;
+    std::string message_;
+    Utf8Repair repair_;
+    int timeMultiplier_;
+    size_t start_ = 0;
+    std::vector<std::pair<size_t, size_t> > ranges_;
+    size_t range_ = 0;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    size_t skipped_ = 0;
+};
+
+// Longest record a streaming source waits for. The window grows until a record is complete,
+// so an unclosed quote would otherwise pull the rest of the input into memory.
+inline constexpr size_t csvMaxRecordSize = 4 * 1024 * 1024;
+
+// Streams messages out of a chat CSV read through a ByteReader, e.g. a gzip or zstd file.
+// Decoding runs on a separate thread a few blocks ahead of the parser. Records are parsed
+// from a window holding the current block plus whatever record straddled the previous one.
+class CsvStreamChatSource : public ChatSource {
+public:
+    CsvStreamChatSource(std::filesystem::path filename, int timeMultiplier, UserTable &users)
+        : filename_(std::move(filename)), users_(users), timeMultiplier_(timeMultiplier) {
+        open();
+    }
+
+    ~CsvStreamChatSource() override {
+        if (skipped_ > 0) std::cerr << "Warning: Skipped " << skipped_ << " malformed CSV lines.\n";
+    }
+
+    bool next(ChatMessage &msg) override {
+        while (true) {
+            const std::string_view buf = input_->view();
+            size_t pos = input_->pos();
+            if (skipLine_) {
+                const size_t end = buf.find('\n', pos);
+                skipLine_ = end == std::string_view::npos;
+                pos = skipLine_ ? buf.size() : end + 1;
+            }
+            while (pos < buf.size() && (buf[pos] == '\n' || (buf[pos] == '\r' && pos + 1 < buf.size() && buf[pos + 1] == '\n')))
+                pos += buf[pos] == '\n' ? 1 : 2;
+            input_->setPos(pos);
+            if (pos < buf.size()) {
+                const size_t start = pos;
+                bool complete = csvParseRecord(scanner_, pos, record_);
+                if (!complete && !input_->eof() && buf.size() - start > csvMaxRecordSize) {
+                    // Most likely a quote that is never closed: read the record as if the input
+                    // ended here, which leaves the quote as text up to the line end. A line too
+                    // long for that is dropped.
+                    CsvScanner scanner(buf);
+                    pos = start;
+                    complete = csvParseRecord(scanner, pos, record_);
+                    if (!complete) {
+                        ++skipped_;
+                        skipLine_ = true;
+                        continue;
+                    }
+                }
+                if (complete || input_->eof()) {
+                    input_->setPos(pos);
+                    if (csvRecordToMessage(record_, timeMultiplier_, users_, csvUnescape(record_.fields[1], name_),
+                                           csvUnescape(record_.fields[3], message_), msg)) {
+                        msg.message = repair_(msg.message);
+                        return true;
+                    }
+                    ++skipped_;
+                    continue;
+                }
+            } else if (input_->eof()) {
+                if (input_->failed()) std::cerr << "Error: Could not read all of " << filename_ << "\n";
+                return false;
+            }
+            refill();
+        }
+    }
+
+    bool rewind() override {
+        open();
+        skipped_ = 0;
+        skipLine_ = false;
+        repair_.rewind();
+        return true;
+    }
+
+    bool failed() const override {
+        return input_->failed();
+    }
+
+private:
+    void open() {
+        input_.reset();
+        auto reader = openByteReader(filename_);
+        if (!reader) {
+            std::cerr << "Error: Could not open file " << filename_ << "\n";
+            std::exit(-1);
+        }
+        input_ = std::make_unique<InputWindow>(std::move(reader));
+        while (input_->view().find('\n') == std::string_view::npos && refill()) {
+        }
+        const size_t start = csvSkipHeader(input_->view());
+        if (start == std::string_view::npos) {
+            std::cerr << "Error: Unexpected CSV header format.\n";
+            std::exit(-1);
+        }
+        input_->setPos(start);
+    }
+
+    bool refill() {
+        const bool appended = input_->refill();
+        scanner_ = CsvScanner(input_->view(), !input_->eof());
+        return appended;
+    }
+
+    std::filesystem::path filename_;
+    std::unique_ptr<InputWindow> input_;
+    CsvScanner scanner_{std::string_view()};
+    CsvRecord record_;
+    UserTable &users_;
+    std::string name_;
+    std::string message_;
+    Utf8Repair repair_;
+    int timeMultiplier_;
+    size_t skipped_ = 0;
+    bool skipLine_ = false; // Dropping the rest of an overlong line
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ytt_generator.h"
+
+// Most runs SortedChatSource keeps open at once, which keeps the number of temporary files
+// well under the usual descriptor limits.
+inline constexpr size_t sortMaxRuns = 64;
+
+// Runs SortedChatSource merges into one while spilling: whenever the newest sortMergeRuns runs
+// are of the same tier, they become one run of the next tier. Every message is so rewritten
+// once per tier, and the runs of 4 tiers (up to 16^4 buffers' worth) stay under sortMaxRuns.
+inline constexpr size_t sortMergeRuns = 16;
+
+// Below this many elements per thread, sorting in parallel is not worth starting threads.
+inline constexpr size_t parallelSortMinPart = 1 << 16;
+
+// Stable sort on up to 'threads' threads (0 = one per hardware thread): the range is cut into
+// parts that are sorted concurrently, then merged pairwise, level by level. Both steps are stable.
+template<typename It, typename Less>
+void parallelStableSort(It first, It last, Less less, unsigned threads = 0) {
+    const size_t n = static_cast<size_t>(last - first);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(threads, n / parallelSortMinPart));
+    if (parts == 1) {
+        std::stable_sort(first, last, less);
+        return;
+    }
+
+    std::vector<size_t> bounds(parts + 1);
+    for (size_t i = 0; i <= parts; ++i) bounds[i] = n * i / parts;
+    {
+        std::vector<std::jthread> workers;
+        for (size_t i = 0; i < parts; ++i)
+            workers.emplace_back([&, i] { std::stable_sort(first + bounds[i], first + bounds[i + 1], less); });
+    }
+    for (size_t width = 1; width < parts; width *= 2) {
+        std::vector<std::jthread> workers;
+        for (size_t i = 0; i + width < parts; i += 2 * width) {
+            workers.emplace_back([&, i, width] {
+                std::inplace_merge(first + bounds[i], first + bounds[i + width],
+                                   first + bounds[std::min(i + 2 * width, parts)], less);
+            });
+        }
+    }
+}
+
+// Sorts messages by time, keeping the original order of messages with the same time.
+inline void sortMessages(std::vector<ChatMessage> &messages, unsigned threads = 0) {
+    parallelStableSort(messages.begin(), messages.end(),
+                       [](const ChatMessage &a, const ChatMessage &b) { return a.time < b.time; }, threads);
+}
+
+// Replays another source in timestamp order, for logs merged from several recorders.
+// Messages are buffered (text included, since the source only lends it until the next call)
+// and sorted in memory. When the buffer would grow past 'memoryLimit' bytes, it is sorted and
+// spilled to a temporary file as a run; the runs are then k-way merged from disk. Equal
+// timestamps keep their original order in both cases.
+class SortedChatSource : public ChatSource {
+public:
+    SortedChatSource(std::unique_ptr<ChatSource> inner, size_t memoryLimit, unsigned threads = 0)
+        : inner_(std::move(inner)), memoryLimit_(memoryLimit), threads_(threads) {
+    }
+
+    ~SortedChatSource() override {
+        for (auto &run: runs_) std::fclose(run.file);
+    }
+
+    bool next(ChatMessage &msg) override {
+        if (!loaded_) load();
+        if (runs_.empty()) {
+            if (pos_ >= entries_.size()) return false;
+            const Entry &e = entries_[pos_++];
+            msg.time = e.time;
+            msg.user = e.user;
+            msg.message = std::string_view(text_.data() + e.offset, e.length);
+            return true;
+        }
+        if (!popMerged()) return false;
+        msg.time = currentEntry_.time;
+        msg.user = currentEntry_.user;
+        msg.message = current_;
+        return true;
+    }
+
+    bool rewind() override {
+        if (!loaded_) return inner_->rewind();
+        pos_ = 0;
+        if (!runs_.empty()) startMerge();
+        return true;
+    }
+
+    bool failed() const override {
+        return inner_->failed() || ioFailed_;
+    }
+
+private:
+    struct Entry {
+        uint64_t time;
+        uint32_t user;
+        uint32_t length;
+        uint64_t offset; // Into text_
+    };
+
+    struct Run {
+        std::FILE *file;
+        size_t tier; // Number of merges its records went through
+        Entry head; // Current record; its text is in 'text'
+        std::string text;
+    };
+
+    // Min-heap on (time, run index); the run index breaks ties, since earlier runs hold earlier input.
+    using HeapItem = std::pair<uint64_t, size_t>;
+
+    void load() {
+        loaded_ = true;
+        ChatMessage msg;
+        while (inner_->next(msg)) {
+            if (!makeRoom(msg.message.size())) {
+                spill();
+                makeRoom(msg.message.size());
+            }
+            entries_.push_back({msg.time, msg.user, static_cast<uint32_t>(msg.message.size()), text_.size()});
+            text_.insert(text_.end(), msg.message.begin(), msg.message.end());
+        }
+        if (!runs_.empty()) {
+            if (!entries_.empty()) spill();
+            entries_ = {};
+            text_ = {};
+            std::cerr << "Note: Sorted the chat in " << runs_.size() << " runs on disk.\n";
+            startMerge();
+            return;
+        }
+        sortEntries();
+    }
+
+    // Grows the buffer by hand to fit one more message of 'length' bytes, so that its capacity
+    // rather than just its size stays within the memory limit. Returns false if the buffer has to
+    // be spilled first. An empty buffer always grows, so a message over the limit still fits.
+    bool makeRoom(size_t length) {
+        const bool entriesFull = entries_.size() == entries_.capacity();
+        const bool textFull = text_.size() + length > text_.capacity();
+        if (!entriesFull && !textFull) return true;
+        const size_t used = entries_.capacity() * sizeof(Entry) + text_.capacity();
+        size_t spare = used < memoryLimit_ ? memoryLimit_ - used : 0;
+        size_t entries = entries_.capacity(), text = text_.capacity();
+        if (entriesFull) {
+            // Double, within the spare memory, half of it if the text needs room too.
+            entries += std::min(std::max<size_t>(entries, 256), spare / sizeof(Entry) / (textFull ? 2 : 1));
+            spare -= (entries - entries_.capacity()) * sizeof(Entry);
+        }
+        if (textFull) text += std::min(std::max(text, length), spare);
+        if ((entries == entries_.size() || text_.size() + length > text) && !entries_.empty()) return false;
+        entries_.reserve(std::max(entries, entries_.size() + 1));
+        text_.reserve(std::max(text, text_.size() + length));
+        return true;
+    }
+
+    void sortEntries() {
+        parallelStableSort(entries_.begin(), entries_.end(),
+                           [](const Entry &a, const Entry &b) { return a.time < b.time; }, threads_);
+    }
+
+    // Writes the sorted buffer to a temporary file as one run: time, user, length, text per record.
+    // The buffer is emptied but keeps its capacity for the next run.
+    void spill() {
+        sortEntries();
+        std::FILE *file = createRunFile();
+        bool ok = true;
+        for (const Entry &e: entries_)
+            ok = ok && writeRecord(file, e, std::string_view(text_.data() + e.offset, e.length));
+        finishRunFile(file, 0, ok);
+        entries_.clear();
+        text_.clear();
+        // Tiers only go down along runs_, so the newest runs share a tier if the first of them
+        // has the one of the last. Past sortMaxRuns runs, the newest are merged regardless.
+        while (runs_.size() >= sortMergeRuns) {
+            const size_t first = runs_.size() - sortMergeRuns;
+            if (runs_[first].tier != runs_.back().tier && runs_.size() < sortMaxRuns) break;
+            mergeRuns(first);
+        }
+    }
+
+    // Merges the runs from 'first' on into one. They hold the latest input, so the merged run
+    // keeps their place behind the runs before them.
+    void mergeRuns(size_t first) {
+        std::FILE *file = createRunFile();
+        bool ok = true;
+        startMerge(first);
+        while (ok && popMerged()) ok = writeRecord(file, currentEntry_, current_);
+        const size_t tier = runs_[first].tier + 1;
+        for (size_t i = first; i < runs_.size(); ++i) std::fclose(runs_[i].file);
+        runs_.resize(first);
+        finishRunFile(file, tier, ok && !ioFailed_);
+    }
+
+    static std::FILE *createRunFile() {
+        std::FILE *file = std::tmpfile();
+        if (!file) {
+            std::cerr << "Error: Cannot create a temporary file for sorting\n";
+            std::exit(-1);
+        }
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        return file;
+    }
+
+    void finishRunFile(std::FILE *file, size_t tier, bool ok) {
+        if (!ok || std::fflush(file) != 0) {
+            std::cerr << "Error: Failed to write a temporary file for sorting\n";
+            std::exit(-1);
+        }
+        runs_.push_back({file, tier, {}, {}});
+    }
+
+    static bool writeRecord(std::FILE *file, const Entry &e, std::string_view text) {
+        return std::fwrite(&e.time, sizeof(e.time), 1, file) == 1 &&
+               std::fwrite(&e.user, sizeof(e.user), 1, file) == 1 &&
+               std::fwrite(&e.length, sizeof(e.length), 1, file) == 1 &&
+               std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    }
+
+    bool readRecord(Run &run) {
+        Entry &e = run.head;
+        if (std::fread(&e.time, sizeof(e.time), 1, run.file) != 1) return false;
+        bool ok = std::fread(&e.user, sizeof(e.user), 1, run.file) == 1 &&
+                  std::fread(&e.length, sizeof(e.length), 1, run.file) == 1;
+        if (ok) {
+            run.text.resize(e.length);
+            ok = std::fread(run.text.data(), 1, e.length, run.file) == e.length;
+        }
+        if (!ok) {
+            std::cerr << "Error: Failed to read back a temporary file for sorting\n";
+            ioFailed_ = true;
+        }
+        return ok;
+    }
+
+    // Takes the smallest head off the heap into currentEntry_ and current_.
+    bool popMerged() {
+        if (heap_.empty()) return false;
+        const size_t i = heap_.top().second;
+        heap_.pop();
+        Run &run = runs_[i];
+        currentEntry_ = run.head;
+        current_.swap(run.text);
+        if (readRecord(run)) heap_.emplace(run.head.time, i);
+        return true;
+    }
+
+    // Starts merging the runs from 'first' on.
+    void startMerge(size_t first = 0) {
+        heap_ = {};
+        for (size_t i = first; i < runs_.size(); ++i) {
+            std::rewind(runs_[i].file);
+            if (readRecord(runs_[i])) heap_.emplace(runs_[i].head.time, i);
+        }
+    }
+
+    std::unique_ptr<ChatSource> inner_;
+    size_t memoryLimit_;
+    unsigned threads_;
+    bool loaded_ = false;
+    bool ioFailed_ = false;
+
+    // In-memory mode
+    std::vector<Entry> entries_;
+    std::vector<char> text_; // Not a string, whose reserve may round up past the limit
+    size_t pos_ = 0;
+
+    // Spilled mode
+    std::vector<Run> runs_;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<> > heap_;
+    Entry currentEntry_{};
+    std::string current_;
+};
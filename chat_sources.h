@@ -0,0 +1,570 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "byte_stream.h"
+#include "json_reader.h"
+#include "ytt_generator.h"
+
+enum class ChatFormat {
+    Auto, Csv, TwitchJson, TwitchIrc, YoutubeJsonl
+};
+
+// Guesses the format from the file extension, looking through a trailing .gz or .zst.
+inline ChatFormat detectChatFormat(const std::filesystem::path &path) {
+    std::filesystem::path name = path.filename();
+    const std::string outer = name.extension().string();
+    if (outer == ".gz" || outer == ".zst") name = name.stem();
+    const std::filesystem::path ext = name.extension();
+    if (ext == ".json") {
+        // yt-dlp names YouTube replays *.live_chat.json, although they hold one JSON object per line.
+        return name.stem().extension() == ".live_chat" ? ChatFormat::YoutubeJsonl : ChatFormat::TwitchJson;
+    }
+    if (ext == ".jsonl") return ChatFormat::YoutubeJsonl;
+    if (ext == ".irc" || ext == ".log") return ChatFormat::TwitchIrc;
+    return ChatFormat::Csv;
+}
+
+// Streams messages out of a TwitchDownloader chat JSON file:
+//   {"comments": [{"content_offset_seconds": 12.3,
+//                  "commenter": {"display_name": "..."},
+//                  "message": {"body": "...", "user_color": "#RRGGBB" | null}}, ...], ...}
+// The document is never built in memory: a pull tokenizer walks the "comments" array and
+// skips every other value, so memory use does not depend on the file size.
+class TwitchJsonChatSource : public ChatSource {
+public:
+    TwitchJsonChatSource(std::filesystem::path filename, UserTable &users)
+        : filename_(std::move(filename)), users_(users) {
+        open();
+    }
+
+    ~TwitchJsonChatSource() override {
+        if (skipped_ > 0) std::cerr << "Warning: Skipped " << skipped_ << " malformed comments.\n";
+    }
+
+    bool next(ChatMessage &msg) override {
+        while (!done_) {
+            const JsonEvent event = json_->next();
+            if (event == JsonEvent::EndArray) {
+                done_ = true;
+                break;
+            }
+            if (event != JsonEvent::BeginObject) {
+                if (event == JsonEvent::End || event == JsonEvent::Error) return fail();
+                ++skipped_;
+                json_->skip(event);
+                continue;
+            }
+            if (!readComment()) return fail();
+            if (!hasTime_ || !hasName_) {
+                ++skipped_;
+                continue;
+            }
+            msg.time = time_;
+            msg.user = color_.empty() ? users_.internDefault(name_) : users_.intern(name_, Color(color_));
+            msg.message = repair_(message_);
+            return true;
+        }
+        return false;
+    }
+
+    bool rewind() override {
+        open();
+        skipped_ = 0;
+        repair_.rewind();
+        return true;
+    }
+
+    bool failed() const override {
+        return failed_;
+    }
+
+private:
+    void open() {
+        json_.reset();
+        input_.reset();
+        auto reader = openByteReader(filename_);
+        if (!reader) {
+            std::cerr << "Error: Could not open file " << filename_ << "\n";
+            std::exit(-1);
+        }
+        input_ = std::make_unique<InputWindow>(std::move(reader));
+        json_ = std::make_unique<JsonReader>(*input_);
+        done_ = false;
+        failed_ = false;
+        if (json_->next() == JsonEvent::BeginObject) {
+            for (JsonEvent event = json_->next(); event == JsonEvent::Key; event = json_->next()) {
+                if (json_->value() == "comments") {
+                    if (json_->next() == JsonEvent::BeginArray) return;
+                    break;
+                }
+                json_->skipValue();
+            }
+        }
+        std::cerr << "Error: No \"comments\" array found in " << filename_ << "\n";
+        std::exit(-1);
+    }
+
+    // Reads the fields of one comment object, up to and including its closing brace.
+    bool readComment() {
+        hasTime_ = hasName_ = false;
+        name_.clear();
+        color_.clear();
+        message_.clear();
+        for (JsonEvent event = json_->next(); event != JsonEvent::EndObject; event = json_->next()) {
+            if (event != JsonEvent::Key) return false;
+            const std::string_view key = json_->value();
+            if (key == "content_offset_seconds") {
+                event = json_->next();
+                if (event == JsonEvent::Number) hasTime_ = parseSeconds(json_->value());
+                else json_->skip(event);
+            } else if (key == "commenter") {
+                if (!readObject([this](std::string_view field, JsonEvent value) {
+                    if (field != "display_name" || value != JsonEvent::String) return false;
+                    name_ = json_->value();
+                    hasName_ = true;
+                    return true;
+                }))
+                    return false;
+            } else if (key == "message") {
+                if (!readObject([this](std::string_view field, JsonEvent value) {
+                    if (value != JsonEvent::String) return false;
+                    if (field == "body") message_ = json_->value();
+                    else if (field == "user_color") color_ = json_->value();
+                    else return false;
+                    return true;
+                }))
+                    return false;
+            } else {
+                event = json_->skipValue();
+            }
+            if (event == JsonEvent::End || event == JsonEvent::Error) return false;
+        }
+        return true;
+    }
+
+    // Walks a nested object, handing each key and the first event of its value to 'field'.
+    // Values the callback does not take (returns false for) are skipped.
+    template<class OnField>
+    bool readObject(OnField &&field) {
+        JsonEvent event = json_->next();
+        if (event != JsonEvent::BeginObject) {
+            json_->skip(event);
+            return event != JsonEvent::End && event != JsonEvent::Error;
+        }
+        for (event = json_->next(); event == JsonEvent::Key; event = json_->next()) {
+            // The key is copied: reading the value replaces json_->value().
+            key_ = json_->value();
+            const JsonEvent value = json_->next();
+            if (!field(key_, value)) json_->skip(value);
+        }
+        return event == JsonEvent::EndObject;
+    }
+
+    bool parseSeconds(std::string_view text) {
+        double seconds = 0;
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), seconds);
+        if (ec != std::errc()) return false;
+        time_ = seconds > 0 ? static_cast<uint64_t>(std::llround(seconds * 1000)) : 0;
+        return true;
+    }
+
+    bool fail() {
+        if (input_->failed()) std::cerr << "Error: Could not read all of " << filename_ << "\n";
+        else std::cerr << "Error: Truncated or malformed JSON in " << filename_ << "\n";
+        done_ = true;
+        failed_ = true;
+        return false;
+    }
+
+    std::filesystem::path filename_;
+    std::unique_ptr<InputWindow> input_;
+    std::unique_ptr<JsonReader> json_;
+    UserTable &users_;
+    std::string key_;
+    std::string name_;
+    std::string color_;
+    std::string message_;
+    uint64_t time_ = 0;
+    bool hasTime_ = false;
+    bool hasName_ = false;
+    bool done_ = false;
+    bool failed_ = false;
+    size_t skipped_ = 0;
+    Utf8Repair repair_;
+};
+
+// Undoes IRCv3 tag value escaping (\: \s \\ \r \n). Values without backslashes are returned as is;
+// otherwise the result lives in 'scratch'.
+inline std::string_view ircUnescapeTag(std::string_view value, std::string &scratch) {
+    if (value.find('\\') == std::string_view::npos) return value;
+    scratch.clear();
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '\\') {
+            scratch += value[i];
+            continue;
+        }
+        if (++i == value.size()) break; // A trailing lone backslash is dropped
+        switch (value[i]) {
+            case ':': scratch += ';'; break;
+            case 's': scratch += ' '; break;
+            case 'r': scratch += '\r'; break;
+            case 'n': scratch += '\n'; break;
+            default: scratch += value[i]; break;
+        }
+    }
+    return scratch;
+}
+
+// The parts of an IRC PRIVMSG line the subtitles need. All views point into the line.
+struct IrcPrivmsg {
+    std::string_view nick;
+    std::string_view displayName; // still escaped
+    std::string_view color;
+    std::string_view sentTs;
+    std::string_view text;
+};
+
+// Splits a raw IRC line of the form
+//   @tag=value;tag=value :nick!user@host PRIVMSG #channel :text
+// Returns false for anything that is not a PRIVMSG. Only the tags used here are picked out;
+// the rest are stepped over without being copied.
+inline bool ircParsePrivmsg(std::string_view line, IrcPrivmsg &msg) {
+    msg = {};
+    auto word = [&line]() {
+        const size_t space = line.find(' ');
+        const std::string_view w = line.substr(0, space);
+        line.remove_prefix(space == std::string_view::npos ? line.size() : space);
+        while (!line.empty() && line.front() == ' ') line.remove_prefix(1);
+        return w;
+    };
+
+    if (line.starts_with('@')) {
+        std::string_view tags = word().substr(1);
+        while (!tags.empty()) {
+            const size_t end = tags.find(';');
+            const std::string_view tag = tags.substr(0, end);
+            tags.remove_prefix(end == std::string_view::npos ? tags.size() : end + 1);
+            const size_t eq = tag.find('=');
+            if (eq == std::string_view::npos) continue;
+            const std::string_view key = tag.substr(0, eq);
+            const std::string_view value = tag.substr(eq + 1);
+            if (key == "display-name") msg.displayName = value;
+            else if (key == "color") msg.color = value;
+            else if (key == "tmi-sent-ts") msg.sentTs = value;
+        }
+    }
+    if (line.starts_with(':')) {
+        const std::string_view prefix = word().substr(1);
+        msg.nick = prefix.substr(0, prefix.find('!'));
+    }
+    if (word() != "PRIVMSG") return false;
+    word(); // channel
+    if (!line.starts_with(':')) return false;
+    msg.text = line.substr(1);
+    // /me messages arrive as CTCP ACTION; show just their text.
+    constexpr std::string_view action = "\x01" "ACTION ";
+    if (msg.text.starts_with(action)) {
+        msg.text.remove_prefix(action.size());
+        if (msg.text.ends_with('\x01')) msg.text.remove_suffix(1);
+    }
+    return true;
+}
+
+// Streams messages out of a raw Twitch IRC log, one protocol line per message, as written by
+// a bot connected with the twitch.tv/tags capability. Lines other than PRIVMSG are ignored.
+// Times come from the tmi-sent-ts tag and are made relative to the first message.
+class IrcChatSource : public ChatSource {
+public:
+    IrcChatSource(std::filesystem::path filename, UserTable &users) : filename_(std::move(filename)), users_(users) {
+        open();
+    }
+
+    ~IrcChatSource() override {
+        if (skipped_ > 0) std::cerr << "Warning: Skipped " << skipped_ << " PRIVMSG lines without a usable tmi-sent-ts.\n";
+    }
+
+    bool next(ChatMessage &msg) override {
+        std::string_view line;
+        while (input_->nextLine(line)) {
+            if (!ircParsePrivmsg(line, privmsg_)) continue;
+            uint64_t sent = 0;
+            const auto [ptr, ec] = std::from_chars(privmsg_.sentTs.data(), privmsg_.sentTs.data() + privmsg_.sentTs.size(), sent);
+            if (ec != std::errc() || privmsg_.sentTs.empty()) {
+                ++skipped_;
+                continue;
+            }
+            if (!haveBase_) {
+                base_ = sent;
+                haveBase_ = true;
+            }
+            const std::string_view name = privmsg_.displayName.empty()
+                                              ? privmsg_.nick
+                                              : ircUnescapeTag(privmsg_.displayName, name_);
+            msg.time = sent > base_ ? sent - base_ : 0;
+            msg.user = privmsg_.color.empty() ? users_.internDefault(name) : users_.intern(name, Color(privmsg_.color));
+            msg.message = repair_(privmsg_.text);
+            return true;
+        }
+        if (input_->failed()) std::cerr << "Error: Could not read all of " << filename_ << "\n";
+        return false;
+    }
+
+    bool rewind() override {
+        open();
+        skipped_ = 0;
+        repair_.rewind();
+        return true;
+    }
+
+    bool failed() const override {
+        return input_->failed();
+    }
+
+private:
+    void open() {
+        input_.reset();
+        auto reader = openByteReader(filename_);
+        if (!reader) {
+            std::cerr << "Error: Could not open file " << filename_ << "\n";
+            std::exit(-1);
+        }
+        input_ = std::make_unique<InputWindow>(std::move(reader));
+        haveBase_ = false;
+    }
+
+    std::filesystem::path filename_;
+    std::unique_ptr<InputWindow> input_;
+    IrcPrivmsg privmsg_;
+    UserTable &users_;
+    std::string name_;
+    uint64_t base_ = 0;
+    bool haveBase_ = false;
+    size_t skipped_ = 0;
+    Utf8Repair repair_;
+};
+
+// Streams messages out of a YouTube live chat replay as saved by yt-dlp: JSON Lines, one
+//   {"replayChatItemAction": {"actions": [{"addChatItemAction": {"item": {"liveChatTextMessageRenderer":
+//       {"message": {"runs": [{"text": "..."}, {"emoji": {...}}]}, "authorName": {"simpleText": "..."}}}}}],
+//    "videoOffsetTimeMsec": "12345"}}
+// per line. Lines without a text message (super chats, membership items, tickers, deletions...)
+// are rejected by a substring search before any JSON is tokenized.
+// Files recorded live carry no video offset; their times come from timestampUsec, relative to
+// the first message.
+class YoutubeChatSource : public ChatSource {
+public:
+    YoutubeChatSource(std::filesystem::path filename, UserTable &users)
+        : filename_(std::move(filename)), users_(users) {
+        open();
+    }
+
+    ~YoutubeChatSource() override {
+        if (skipped_ > 0) std::cerr << "Warning: Skipped " << skipped_ << " malformed chat replay lines.\n";
+    }
+
+    bool next(ChatMessage &msg) override {
+        while (pendingPos_ == pending_.size()) {
+            std::string_view line;
+            if (!input_->nextLine(line)) {
+                if (input_->failed()) std::cerr << "Error: Could not read all of " << filename_ << "\n";
+                return false;
+            }
+            if (line.find("\"liveChatTextMessageRenderer\"") == std::string_view::npos) continue;
+            if (!parseLine(line)) ++skipped_;
+        }
+        const Pending &p = pending_[pendingPos_++];
+        msg.time = p.time;
+        msg.user = p.user;
+        msg.message = repair_(p.text);
+        return true;
+    }
+
+    bool rewind() override {
+        open();
+        skipped_ = 0;
+        repair_.rewind();
+        return true;
+    }
+
+    bool failed() const override {
+        return input_->failed();
+    }
+
+private:
+    // Keys that matter for picking a message out of a line; everything else is Other.
+    // Array marks a nesting level that is an array rather than an object.
+    enum class Key : uint8_t {
+        Other, Array, VideoOffset, Renderer, Message, Runs, Text, Emoji, EmojiId, Shortcuts, IsCustomEmoji,
+        AuthorName, SimpleText, TimestampUsec
+    };
+
+    struct Pending {
+        uint64_t time = 0;
+        uint32_t user = UserTable::none;
+        std::string text;
+        uint64_t timestampUsec = 0;
+    };
+
+    static Key classify(std::string_view key) {
+        if (key == "text") return Key::Text;
+        if (key == "emoji") return Key::Emoji;
+        if (key == "emojiId") return Key::EmojiId;
+        if (key == "shortcuts") return Key::Shortcuts;
+        if (key == "isCustomEmoji") return Key::IsCustomEmoji;
+        if (key == "runs") return Key::Runs;
+        if (key == "message") return Key::Message;
+        if (key == "authorName") return Key::AuthorName;
+        if (key == "simpleText") return Key::SimpleText;
+        if (key == "liveChatTextMessageRenderer") return Key::Renderer;
+        if (key == "videoOffsetTimeMsec") return Key::VideoOffset;
+        if (key == "timestampUsec") return Key::TimestampUsec;
+        return Key::Other;
+    }
+
+    void open() {
+        input_.reset();
+        auto reader = openByteReader(filename_);
+        if (!reader) {
+            std::cerr << "Error: Could not open file " << filename_ << "\n";
+            std::exit(-1);
+        }
+        input_ = std::make_unique<InputWindow>(std::move(reader));
+        pending_.clear();
+        pendingPos_ = 0;
+        haveBase_ = false;
+    }
+
+    bool under(Key key) const {
+        return std::find(path_.begin(), path_.end(), key) != path_.end();
+    }
+
+    // Key of the value just read: the innermost key, or the key of the enclosing array.
+    Key valueKey(size_t depth) const {
+        if (depth == 0) return Key::Other;
+        if (path_[depth - 1] == Key::Array && depth >= 2) return path_[depth - 2];
+        return path_[depth - 1];
+    }
+
+    static bool parseNumber(std::string_view text, int64_t &value) {
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec == std::errc() && ptr == text.data() + text.size();
+    }
+
+    // Collects every text message renderer in the line into pending_.
+    bool parseLine(std::string_view line) {
+        pending_.clear();
+        pendingPos_ = 0;
+        path_.clear();
+        json_.reset(line);
+        int64_t offset = 0;
+        bool haveOffset = false;
+        bool inRenderer = false;
+        Pending current;
+        std::string emojiId, shortcut;
+        bool custom = false;
+        bool haveName = false;
+
+        for (JsonEvent event = json_.next(); event != JsonEvent::End; event = json_.next()) {
+            const size_t depth = json_.depth();
+            switch (event) {
+                case JsonEvent::Error:
+                    return false;
+                case JsonEvent::BeginObject:
+                case JsonEvent::BeginArray:
+                    path_.resize(depth, Key::Other);
+                    if (event == JsonEvent::BeginArray) path_[depth - 1] = Key::Array;
+                    if (depth >= 2 && path_[depth - 2] == Key::Renderer && event == JsonEvent::BeginObject && !inRenderer) {
+                        inRenderer = true;
+                        current = {};
+                        haveName = false;
+                    }
+                    break;
+                case JsonEvent::EndObject:
+                case JsonEvent::EndArray: {
+                    path_.resize(depth);
+                    const Key closed = depth > 0 ? path_[depth - 1] : Key::Other;
+                    if (!inRenderer || event != JsonEvent::EndObject) break;
+                    if (closed == Key::Emoji) {
+                        // Standard emoji carry the character itself as their id; custom ones only have a name.
+                        current.text += custom && !shortcut.empty() ? shortcut : emojiId;
+                        emojiId.clear();
+                        shortcut.clear();
+                        custom = false;
+                    } else if (closed == Key::Renderer) {
+                        inRenderer = false;
+                        if (haveName) pending_.push_back(std::move(current));
+                    }
+                    break;
+                }
+                case JsonEvent::Key:
+                    path_[depth - 1] = classify(json_.value());
+                    break;
+                case JsonEvent::String:
+                case JsonEvent::Number:
+                case JsonEvent::Literal: {
+                    const Key key = valueKey(depth);
+                    if (key == Key::VideoOffset) {
+                        haveOffset = parseNumber(json_.value(), offset);
+                    } else if (inRenderer) {
+                        if (key == Key::Text && under(Key::Runs)) {
+                            current.text += json_.value();
+                        } else if (key == Key::EmojiId) {
+                            emojiId = json_.value();
+                        } else if (key == Key::Shortcuts) {
+                            if (shortcut.empty()) shortcut = json_.value();
+                        } else if (key == Key::IsCustomEmoji) {
+                            custom = json_.value() == "true";
+                        } else if (key == Key::SimpleText && depth >= 2 && path_[depth - 2] == Key::AuthorName) {
+                            // YouTube has no name colors.
+                            current.user = users_.internDefault(json_.value());
+                            haveName = true;
+                        } else if (key == Key::TimestampUsec) {
+                            int64_t usec = 0;
+                            if (parseNumber(json_.value(), usec) && usec > 0) current.timestampUsec = usec;
+                        }
+                    }
+                    break;
+                }
+                case JsonEvent::End:
+                    break;
+            }
+        }
+        if (pending_.empty()) return true;
+
+        for (Pending &p: pending_) {
+            if (haveOffset) {
+                p.time = offset > 0 ? static_cast<uint64_t>(offset) : 0;
+                continue;
+            }
+            if (p.timestampUsec == 0) {
+                pending_.clear();
+                return false;
+            }
+            if (!haveBase_) {
+                base_ = p.timestampUsec;
+                haveBase_ = true;
+            }
+            p.time = p.timestampUsec > base_ ? (p.timestampUsec - base_) / 1000 : 0;
+        }
+        return true;
+    }
+
+    std::filesystem::path filename_;
+    std::unique_ptr<InputWindow> input_;
+    JsonReader json_{std::string_view()};
+    std::vector<Key> path_;
+    std::vector<Pending> pending_;
+    size_t pendingPos_ = 0;
+    UserTable &users_;
+    uint64_t base_ = 0;
+    bool haveBase_ = false;
+    size_t skipped_ = 0;
+    Utf8Repair repair_;
+};
@@ -1,31 +1,117 @@
 #include "ytt_generator.h"
+#include "chat_cache.h"
+#include "chat_reader.h"
+#include "chat_sources.h"
+#include "chat_sort.h"
+#include "time_index.h"
 #include <CLI/CLI.hpp>
+#include <cstdio>
+#include <algorithm>
+#include <deque>
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <vector>
 #include <string>
 
+// One -i input with the format, time unit and offset that apply to it.
+struct Input {
+    std::filesystem::path path;
+    ChatFormat format = ChatFormat::Auto;
+    int multiplier = 1;
+    int64_t offset = 0; // Milliseconds added to every message time
+    ChatCache cache;
+    ChatLog chat;
+};
+
+// Parses an offset such as "90", "-00:01:30" or "1.5" into milliseconds.
+static bool parseOffset(std::string_view text, int64_t &offset) {
+    const bool negative = !text.empty() && text[0] == '-';
+    uint64_t ms = 0;
+    if (!parseClockTime(text.substr(negative ? 1 : 0), ms) || ms > static_cast<uint64_t>(INT64_MAX)) return false;
+    offset = negative ? -static_cast<int64_t>(ms) : static_cast<int64_t>(ms);
+    return true;
+}
+
+// Moves a time of the output timeline into the timeline of an input shifted by 'offset'. Times
+// before the start of the input become 0, so the result never excludes a message it should include.
+static uint64_t inputTime(uint64_t time, int64_t offset) {
+    if (offset >= 0) return time > static_cast<uint64_t>(offset) ? time - offset : 0;
+    const uint64_t shift = static_cast<uint64_t>(-offset);
+    return time > UINT64_MAX - shift ? UINT64_MAX : time + shift;
+}
+
 int main(int argc, char *argv[]) {
     CLI::App app{"Chat → YTT/SRV3 subtitle generator"};
 
-    std::filesystem::path configPath, csvPath, outputPath;
-    std::string timeUnit;
+    std::filesystem::path configPath, outputPath;
+    std::vector<std::filesystem::path> inputPaths;
+    std::vector<std::string> timeUnits{"ms"};
+    std::vector<std::string> formats{"auto"};
+    std::vector<std::string> offsetTexts{"0"};
+    std::string fromText, toText;
+    unsigned threads = 0;
+    bool stream = false;
+    bool noCache = false;
+    bool sort = false;
+    size_t sortMemory = 1024;
 
     app.add_option("-c,--config", configPath, "Path to INI config file")
             ->required()
             ->check(CLI::ExistingFile);
-    app.add_option("-i,--input", csvPath, "Path to chat CSV file")
+    app.add_option("-i,--input", inputPaths, "Path to chat CSV, TwitchDownloader JSON, raw IRC log or YouTube live chat replay (may be gzip or zstd compressed), or “-” for standard input; repeat to merge several chats")
             ->required()
-            ->check(CLI::ExistingFile);
-    app.add_option("-o,--output", outputPath, "Output file (e.g. output.srv3 or output.ytt)")
+            ->check(CLI::ExistingFile | CLI::IsMember({"-"}));
+    app.add_option("-o,--output", outputPath, "Output file (e.g. output.srv3 or output.ytt), or “-” for standard output")
             ->required();
-    app.add_option("-u,--time-unit", timeUnit, "Time unit inside CSV: “ms” or “sec”")
-            ->required()
+    app.add_option("-f,--format", formats, "Input format: “auto” (by extension), “csv”, “twitch-json”, “twitch-irc” or “youtube”; once for all inputs or once per input")
+            ->capture_default_str()
+            ->check(CLI::IsMember({"auto", "csv", "twitch-json", "twitch-irc", "youtube"}, CLI::ignore_case));
+    app.add_option("-u,--time-unit", timeUnits, "Time unit inside CSV: “ms” or “sec”; once for all inputs or once per input")
+            ->capture_default_str()
             ->check(CLI::IsMember({"ms", "sec"}, CLI::ignore_case));
+    app.add_option("--offset", offsetTexts, "Time added to the messages of an input (e.g. 5.5 or -00:01:00); once for all inputs or once per input")
+            ->capture_default_str();
+
+    app.add_option("-j,--threads", threads, "Threads used to parse the CSV and to wrap messages (0 = all cores)")
+            ->capture_default_str();
+    app.add_flag("--stream", stream,
+                 "Read the CSV incrementally instead of loading it whole (bounded memory, single-threaded parsing)");
+    app.add_flag("--no-cache", noCache,
+                 "Neither read nor write the chat cache (<input>.scc) or time index (<input>.sci) next to the input");
+    app.add_flag("--sort", sort, "Sort messages by time first, for logs that are out of order");
+    app.add_option("--sort-memory", sortMemory, "Memory (MiB) --sort may use before spilling sorted runs to disk")
+            ->capture_default_str()
+            ->check(CLI::PositiveNumber);
+    app.add_option("--from", fromText, "Only render messages from this time on (e.g. 03:10:00); output starts at 0");
+    app.add_option("--to", toText, "Only render messages up to this time (e.g. 04:00:00)");
 
     CLI11_PARSE(app, argc, argv);
 
-    int multiplier = (timeUnit == "sec") ? 1000 : 1;
+    for (const auto *values: {&timeUnits, &formats, &offsetTexts}) {
+        if (values->size() != 1 && values->size() != inputPaths.size()) {
+            std::cerr << "Error: -f, -u and --offset take either one value or one per input\n";
+            return 1;
+        }
+    }
+    if (std::ranges::count_if(inputPaths, isStdio) > 1) {
+        std::cerr << "Error: Standard input can only be read once\n";
+        return 1;
+    }
+    auto perInput = [](const std::vector<std::string> &values, size_t i) -> const std::string & {
+        return values.size() == 1 ? values[0] : values[i];
+    };
+
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    if ((!fromText.empty() && !parseClockTime(fromText, from)) || (!toText.empty() && !parseClockTime(toText, to))) {
+        std::cerr << "Error: Times must look like HH:MM:SS, MM:SS or seconds, optionally with .mmm\n";
+        return 1;
+    }
+    if (from > to) {
+        std::cerr << "Error: --from is later than --to\n";
+        return 1;
+    }
+    const bool clip = !fromText.empty() || !toText.empty();
 
     ChatParams params;
     if (!params.loadFromFile(configPath.c_str())) {
@@ -33,20 +119,134 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    auto chat = parseCSV(csvPath, multiplier);
-    if (chat.empty()) {
-        std::cerr << "Error: Failed to parse chat CSV or it's empty: " << csvPath << "\n";
-        return 1;
+    // Every source interns its users here; messages and wrapped lines refer to them by id.
+    UserTable users;
+    std::deque<Input> inputs;
+    std::vector<std::unique_ptr<ChatSource> > sources;
+    for (size_t i = 0; i < inputPaths.size(); ++i) {
+        Input &input = inputs.emplace_back();
+        input.path = inputPaths[i];
+        input.multiplier = (perInput(timeUnits, i) == "sec") ? 1000 : 1;
+        if (!parseOffset(perInput(offsetTexts, i), input.offset)) {
+            std::cerr << "Error: Offsets must look like HH:MM:SS, MM:SS or seconds, optionally with .mmm and a leading -\n";
+            return 1;
+        }
+        const std::string &format = perInput(formats, i);
+        if (format == "csv") input.format = ChatFormat::Csv;
+        else if (format == "twitch-json") input.format = ChatFormat::TwitchJson;
+        else if (format == "twitch-irc") input.format = ChatFormat::TwitchIrc;
+        else if (format == "youtube") input.format = ChatFormat::YoutubeJsonl;
+        if (input.format == ChatFormat::Auto) input.format = detectChatFormat(input.path);
+
+        // A cache built from the same input file, format and time unit replaces parsing altogether.
+        // Standard input has no file to key a cache on and can only be read as a stream.
+        const bool fromStdin = isStdio(input.path);
+        const std::filesystem::path cachePath = sccPathFor(input.path);
+        SccKey cacheKey;
+        const bool useCache = !noCache && !fromStdin &&
+                              sccKeyFor(input.path, static_cast<uint32_t>(input.format), input.multiplier, cacheKey);
+        const bool cached = useCache && input.cache.open(cachePath, cacheKey);
+
+        std::unique_ptr<ChatSource> source;
+        bool indexed = false;
+        bool sorted = false;
+        if (cached) {
+            source = std::make_unique<CacheChatSource>(input.cache, users);
+        } else if (input.format == ChatFormat::TwitchJson) {
+            source = std::make_unique<TwitchJsonChatSource>(input.path, users);
+        } else if (input.format == ChatFormat::TwitchIrc) {
+            source = std::make_unique<IrcChatSource>(input.path, users);
+        } else if (input.format == ChatFormat::YoutubeJsonl) {
+            source = std::make_unique<YoutubeChatSource>(input.path, users);
+        } else if (fromStdin || detectCompression(input.path) != InputCompression::None) {
+            source = std::make_unique<CsvStreamChatSource>(input.path, input.multiplier, users);
+        } else if (clip && input.format == ChatFormat::Csv) {
+            // A clip reads only the blocks of the time index that overlap it. The index is built
+            // (by one pass over the file) the first time a clip of this log is rendered.
+            auto csv = std::make_unique<CsvChatSource>(input.path, input.multiplier, users);
+            const std::filesystem::path indexPath = sciPathFor(input.path);
+            std::vector<TimeIndexBlock> blocks;
+            if (!useCache || !readTimeIndex(indexPath, cacheKey, blocks)) {
+                blocks = buildTimeIndex(csv->buffer(), csv->dataStart(), input.multiplier);
+                if (useCache) writeTimeIndex(indexPath, cacheKey, blocks);
+            }
+            csv->restrictTo(timeIndexRanges(blocks, inputTime(from, input.offset), inputTime(to, input.offset)));
+            source = std::move(csv);
+            indexed = true;
+        } else if (stream) {
+            source = std::make_unique<CsvChatSource>(input.path, input.multiplier, users);
+        } else {
+            input.chat = parseCSV(input.path, input.multiplier, threads);
+            if (users.size() == 0) {
+                users = std::move(input.chat.users);
+            } else {
+                const auto ids = users.merge(input.chat.users);
+                for (auto &message: input.chat.messages) message.user = ids[message.user];
+            }
+            if (sort) {
+                sortMessages(input.chat.messages, threads);
+                sorted = true;
+            }
+            source = std::make_unique<VectorChatSource>(input.chat.messages);
+        }
+        if (useCache && !cached && !indexed && writeChatCache(cachePath, *source, users, cacheKey) &&
+            input.cache.open(cachePath, cacheKey)) {
+            source = std::make_unique<CacheChatSource>(input.cache, users);
+            input.chat = ChatLog();
+        }
+        if (input.offset != 0) source = std::make_unique<OffsetChatSource>(std::move(source), input.offset);
+        if (clip) source = std::make_unique<TimeRangeChatSource>(std::move(source), from, to);
+        // Sorting after the clip filter only has to buffer the messages of the clip.
+        if (sort && !sorted) {
+            source = std::make_unique<SortedChatSource>(std::move(source), (sortMemory << 20) / inputPaths.size(),
+                                                        threads);
+        } else if (fromStdin) {
+            // The pen prepass reads the chat twice; standard input is kept in memory for the second pass.
+            source = std::make_unique<ReplayChatSource>(std::move(source));
+        }
+        sources.push_back(std::move(source));
     }
+    // Several inputs are interleaved by time as they are read; each of them is already in order.
+    std::unique_ptr<ChatSource> source = sources.size() == 1
+                                             ? std::move(sources[0])
+                                             : std::make_unique<MergedChatSource>(std::move(sources));
 
-    std::string xml = generateXML(generateBatches(chat,params), params);
+    ChatMessage first;
+    if (!source->next(first)) {
+        std::cerr << "Error: Failed to parse chat log or it's empty:";
+        for (const auto &path: inputPaths) std::cerr << " " << path;
+        std::cerr << "\n";
+        return 1;
+    }
+    source->rewind();
+    // Pens go into the SRV3 header, so their colors are gathered before any batch is written.
+    const auto colors = collectColors(*source, users, params);
 
-    std::ofstream out(outputPath);
+    // Batches are written as they are produced; for a pipe, in large blocks.
+    const bool toStdout = isStdio(outputPath);
+    FILE *out = toStdout ? stdout : std::fopen(outputPath.string().c_str(), "w");
+    if (toStdout) std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
     if (!out) {
         std::cerr << "Error: Cannot open output file: " << outputPath << "\n";
         return 1;
     }
-    out << xml;
+    {
+        tinyxml2::XMLPrinter printer(out);
+        Srv3Writer writer(printer, users, params, colors);
+        generateBatches(*source, users, params, [&](const Batch &batch) { writer.addBatch(batch); }, threads);
+        writer.finish();
+    }
+    if (toStdout) {
+        if (std::fflush(out) != 0) {
+            std::cerr << "Error: Failed to write to standard output\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (std::fclose(out) != 0) {
+        std::cerr << "Error: Failed to write output file: " << outputPath << "\n";
+        return 1;
+    }
     std::cout << "Successfully wrote subtitles to: " << outputPath << "\n";
     return 0;
 }
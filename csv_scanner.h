@@ -0,0 +1,126 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
+
+// Bitmaps of the structural CSV characters inside one 64-byte block.
+// Bit i is set when byte i of the block is that character.
+struct CsvBlockMasks {
+    uint64_t quote = 0;
+    uint64_t comma = 0;
+    uint64_t newline = 0;
+};
+
+inline constexpr size_t csvBlockSize = 64;
+
+// Classifies 64 bytes at once. Uses AVX2 or SSE2 when the compiler targets them, plain loop otherwise.
+inline CsvBlockMasks csvScanBlock(const char *p) {
+    CsvBlockMasks m;
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (int i = 0; i < 2; ++i) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i * 32));
+        const int shift = i * 32;
+        m.quote |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << shift;
+        m.comma |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, comma)))) << shift;
+        m.newline |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)))) << shift;
+    }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (int i = 0; i < 4; ++i) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i * 16));
+        const int shift = i * 16;
+        m.quote |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+        m.comma |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, comma)))) << shift;
+        m.newline |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)))) << shift;
+    }
+#else
+    for (size_t i = 0; i < csvBlockSize; ++i) {
+        const uint64_t bit = uint64_t{1} << i;
+        if (p[i] == '"') m.quote |= bit;
+        else if (p[i] == ',') m.comma |= bit;
+        else if (p[i] == '\n') m.newline |= bit;
+    }
+#endif
+    return m;
+}
+
+// Lazily built structural index over a buffer. Each 64-byte block is classified once,
+// then searches for the next quote/comma/newline are answered from its bitmaps.
+// Searches are expected to move forward through the buffer, as a CSV parser does.
+class CsvScanner {
+public:
+    enum Kind : unsigned {
+        Quote = 1,
+        Comma = 2,
+        Newline = 4,
+    };
+
+    // 'partial' tells that more input may follow the buffer, as in a streaming window.
+    explicit CsvScanner(std::string_view buf, bool partial = false) : buf_(buf), partial_(partial) {
+    }
+
+    std::string_view buffer() const {
+        return buf_;
+    }
+
+    bool partial() const {
+        return partial_;
+    }
+
+    // Returns the position of the first character of one of 'kinds' at or after 'pos', or buffer().size().
+    size_t find(size_t pos, unsigned kinds) {
+        while (pos < buf_.size()) {
+            const size_t block = pos & ~(csvBlockSize - 1);
+            if (block != blockStart_) load(block);
+            uint64_t bits = 0;
+            if (kinds & Quote) bits |= masks_.quote;
+            if (kinds & Comma) bits |= masks_.comma;
+            if (kinds & Newline) bits |= masks_.newline;
+            bits &= ~uint64_t{0} << (pos - block);
+            if (bits != 0) return block + std::countr_zero(bits);
+            pos = block + csvBlockSize;
+        }
+        return buf_.size();
+    }
+
+    size_t findQuote(size_t pos) {
+        return find(pos, Quote);
+    }
+
+    size_t findLineEnd(size_t pos) {
+        return find(pos, Newline);
+    }
+
+    size_t findDelimiter(size_t pos) {
+        return find(pos, Comma | Newline);
+    }
+
+private:
+    void load(size_t block) {
+        blockStart_ = block;
+        if (block + csvBlockSize <= buf_.size()) {
+            masks_ = csvScanBlock(buf_.data() + block);
+        } else {
+            // Tail of the buffer: pad with zeros, which match nothing.
+            char tail[csvBlockSize] = {};
+            std::memcpy(tail, buf_.data() + block, buf_.size() - block);
+            masks_ = csvScanBlock(tail);
+        }
+    }
+
+    std::string_view buf_;
+    bool partial_ = false;
+    size_t blockStart_ = static_cast<size_t>(-1);
+    CsvBlockMasks masks_;
+};
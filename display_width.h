@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include "text_scanner.h"
+#include "unicode_tables.h"
+#include "utf8.h"
+
+// Chat text is laid out in display columns, as a monospace font shows it: every grapheme cluster
+// (UAX #29: a letter with its accents, an emoji ZWJ sequence, a flag, ...) takes two columns when
+// it is wide (CJK, emoji) and one otherwise. Text must be valid UTF-8 (see utf8Sanitize).
+
+// Size in bytes and width in columns of a grapheme cluster.
+struct Grapheme {
+    size_t size;
+    int width;
+};
+
+// What rules GB3 to GB13 of UAX #29 say about a pair of adjacent code points.
+enum class GraphemePair : uint8_t {
+    Break,
+    Join,
+    EmojiZwj, // Joins an Extended_Pictographic after ZWJ in an emoji ZWJ sequence (GB11)
+    Flag, // Joins a regional indicator to an odd number of them (GB12, GB13)
+};
+
+inline constexpr size_t graphemeBreakCount = static_cast<size_t>(GraphemeBreak::LVT) + 1;
+
+// graphemePairs[previous][current], indexed by GraphemeBreak.
+inline constexpr auto graphemePairs = [] {
+    using GB = GraphemeBreak;
+    std::array<std::array<GraphemePair, graphemeBreakCount>, graphemeBreakCount> pairs{};
+    for (size_t p = 0; p < graphemeBreakCount; ++p) {
+        for (size_t c = 0; c < graphemeBreakCount; ++c) {
+            const auto previous = static_cast<GB>(p), current = static_cast<GB>(c);
+            GraphemePair &pair = pairs[p][c];
+            if (previous == GB::CR && current == GB::LF) pair = GraphemePair::Join;
+            else if (previous == GB::CR || previous == GB::LF || previous == GB::Control) pair = GraphemePair::Break;
+            else if (current == GB::CR || current == GB::LF || current == GB::Control) pair = GraphemePair::Break;
+            else if (previous == GB::L && (current == GB::L || current == GB::V || current == GB::LV ||
+                                           current == GB::LVT))
+                pair = GraphemePair::Join;
+            else if ((previous == GB::LV || previous == GB::V) && (current == GB::V || current == GB::T))
+                pair = GraphemePair::Join;
+            else if ((previous == GB::LVT || previous == GB::T) && current == GB::T) pair = GraphemePair::Join;
+            else if (current == GB::Extend || current == GB::ZWJ || current == GB::SpacingMark ||
+                     previous == GB::Prepend)
+                pair = GraphemePair::Join;
+            else if (previous == GB::ZWJ) pair = GraphemePair::EmojiZwj;
+            else if (previous == GB::RegionalIndicator && current == GB::RegionalIndicator) pair = GraphemePair::Flag;
+        }
+    }
+    return pairs;
+}();
+
+// Calls onGrapheme(size, width) for the grapheme clusters of s in order, while it returns true.
+// A cluster is wide if its first code point is, if it asks for emoji presentation (U+FE0F) or
+// if it is a flag (two regional indicators). Every code point is decoded and looked up once.
+template<typename OnGrapheme>
+void forEachGrapheme(std::string_view s, OnGrapheme onGrapheme) {
+    using GB = GraphemeBreak;
+    if (s.empty()) return;
+    auto start = s.begin(); // Of the current cluster
+    GB previous = GB::Control;
+    bool wide = false;
+    bool pictographic = false; // Extended_Pictographic Extend* so far
+    bool emojiZwj = false;
+    int regionalIndicators = 0;
+    for (auto it = s.begin(); it != s.end();) {
+        const auto at = it;
+        const auto c = static_cast<uint8_t>(*it);
+        const char32_t cp = c < 0x80 ? (++it, c) : utf8::unchecked::next(it);
+        const uint8_t properties = unicodeProperties(cp);
+        const GB current = graphemeBreak(cp, properties);
+        bool joins = false;
+        switch (graphemePairs[static_cast<size_t>(previous)][static_cast<size_t>(current)]) {
+            case GraphemePair::Break: break;
+            case GraphemePair::Join: joins = true;
+                break;
+            case GraphemePair::EmojiZwj: joins = emojiZwj && (properties & unicodePictographic);
+                break;
+            case GraphemePair::Flag: joins = regionalIndicators % 2 == 1;
+                break;
+        }
+        if (!joins) {
+            if (at != start && !onGrapheme(static_cast<size_t>(at - start), wide || regionalIndicators == 2 ? 2 : 1))
+                return;
+            start = at;
+            wide = properties & unicodeWide;
+            pictographic = properties & unicodePictographic;
+            emojiZwj = false;
+            regionalIndicators = current == GB::RegionalIndicator;
+        } else {
+            emojiZwj = current == GB::ZWJ && pictographic;
+            if (properties & unicodePictographic) pictographic = true;
+            else if (current != GB::Extend) pictographic = false;
+            if (current == GB::RegionalIndicator) ++regionalIndicators;
+            if (cp == 0xFE0F) wide = true;
+        }
+        previous = current;
+    }
+    onGrapheme(static_cast<size_t>(s.end() - start), wide || regionalIndicators == 2 ? 2 : 1);
+}
+
+// The grapheme cluster at the start of s, which must not be empty.
+inline Grapheme nextGrapheme(std::string_view s) {
+    Grapheme first{};
+    forEachGrapheme(s, [&](size_t size, int width) {
+        first = {size, width};
+        return false;
+    });
+    return first;
+}
+
+// The grapheme cluster that starts at s[pos].
+inline Grapheme graphemeAt(std::string_view s, size_t pos) {
+    // An ASCII character is a cluster of one column by itself, unless it is CR (CR LF is one
+    // cluster) or something like a combining mark follows.
+    const auto c = static_cast<uint8_t>(s[pos]);
+    if (c < 0x80 && c != '\r' && (pos + 1 == s.size() || static_cast<uint8_t>(s[pos + 1]) < 0x80)) return {1, 1};
+    return nextGrapheme(s.substr(pos));
+}
+
+// Whether every character of s is a cluster of one column by itself: ASCII without CR LF.
+inline bool isPlainAscii(std::string_view s) {
+    return s.find('\r') == std::string_view::npos && isAscii(s);
+}
+
+// Width of s in columns.
+inline int displayWidth(std::string_view s) {
+    if (isPlainAscii(s)) return static_cast<int>(s.size());
+    int width = 0;
+    forEachGrapheme(s, [&](size_t, int clusterWidth) {
+        width += clusterWidth;
+        return true;
+    });
+    return width;
+}
+
+// Size in bytes of the longest run of whole grapheme clusters at the start of s that is at most
+// 'width' columns wide. Its width is stored in 'taken'.
+inline size_t displayPrefix(std::string_view s, int width, int &taken) {
+    if (isPlainAscii(s)) {
+        taken = std::clamp(width, 0, static_cast<int>(s.size()));
+        return static_cast<size_t>(taken);
+    }
+    size_t size = 0;
+    taken = 0;
+    forEachGrapheme(s, [&](size_t clusterSize, int clusterWidth) {
+        if (taken + clusterWidth > width) return false;
+        taken += clusterWidth;
+        size += clusterSize;
+        return true;
+    });
+    return size;
+}
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Glyph advance widths of proportional caption fonts YouTube offers, in thousandths of an em,
+// for the pages of code points chat text mostly uses: Latin, Greek, Cyrillic, Vietnamese, general
+// punctuation and letterlike symbols. Other narrow characters take the font's average lowercase
+// advance, and wide ones (CJK, emoji) a whole em, as the fallback fonts that draw them do.
+//
+// The advances come from the Adobe font metrics of the core PostScript fonts, which the Windows
+// fonts were made to match. Characters they lack are taken from DejaVu Sans, Serif and Serif
+// Italic, scaled so that their Latin letters match. Controls and combining marks take no space.
+// Roboto and Comic Sans are measured as Helvetica scaled to their width.
+
+inline constexpr size_t fontPageSize = 256;
+
+// Pages (code point / fontPageSize) that have advances of their own.
+inline constexpr std::array<char32_t, 9> fontPages = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x1E, 0x20, 0x21};
+
+// Index into fontPages by page, -1 where the page uses the fallback.
+inline constexpr auto fontPageIndex = [] {
+    std::array<int8_t, fontPages.back() + 1> index{};
+    index.fill(-1);
+    for (size_t i = 0; i < fontPages.size(); ++i) index[fontPages[i]] = static_cast<int8_t>(i);
+    return index;
+}();
+
+inline constexpr uint16_t fontWideAdvance = 1000;
+
+// Advance of one character of Lucida Console, the font the box is measured in.
+inline constexpr int lucidaConsoleAdvance = 602;
+
+struct FontMetrics {
+    std::array<std::array<uint16_t, fontPageSize>, fontPages.size()> advances;
+    uint16_t fallback; // Narrow characters outside the pages
+    uint16_t wide; // Clusters that are two display columns wide
+};
+
+// Helvetica, whose advances Arial matches. Roboto and Comic Sans are measured with it, scaled to
+// their widths (see robotoFontMetrics).
+inline constexpr FontMetrics sansFontMetrics = {{{
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333, 278, 278, 556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556,
+        1015, 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778, 667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 278, 278, 278, 469, 556,
+        333, 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222, 833, 556, 556, 556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        300, 333, 556, 556, 556, 556, 260, 556, 333, 737, 370, 556, 584, 0, 737, 333, 400, 584, 333, 333, 333, 556, 537, 278, 333, 333, 365, 556, 834, 834, 834, 611,
+        667, 667, 667, 667, 667, 667, 1000, 722, 667, 667, 667, 667, 278, 278, 278, 278, 722, 722, 778, 778, 778, 778, 778, 584, 778, 722, 722, 722, 722, 667, 667, 611,
+        556, 556, 556, 556, 556, 556, 889, 500, 556, 556, 556, 556, 278, 278, 278, 278, 556, 556, 556, 556, 556, 556, 556, 584, 611, 556, 556, 556, 556, 500, 556, 500,
+    }, {
+        667, 556, 667, 556, 667, 556, 722, 500, 659, 519, 659, 519, 722, 500, 722, 643, 722, 556, 667, 556, 597, 581, 667, 556, 667, 556, 667, 556, 732, 599, 778, 556,
+        732, 599, 778, 556, 710, 598, 865, 656, 278, 262, 278, 278, 278, 262, 278, 222, 278, 278, 557, 525, 278, 262, 667, 500, 547, 556, 222, 556, 222, 556, 299, 526,
+        323, 556, 222, 722, 556, 722, 556, 722, 556, 768, 706, 598, 778, 556, 743, 578, 778, 556, 1000, 944, 722, 333, 722, 333, 722, 333, 667, 500, 599, 492, 667, 500,
+        667, 500, 611, 278, 611, 317, 577, 370, 691, 598, 722, 556, 691, 598, 722, 556, 722, 556, 722, 556, 934, 772, 577, 559, 667, 611, 500, 611, 500, 611, 500, 332,
+        599, 694, 648, 599, 648, 599, 664, 659, 519, 732, 773, 648, 599, 578, 597, 743, 580, 543, 556, 732, 648, 929, 334, 278, 704, 547, 262, 559, 920, 706, 598, 743,
+        862, 578, 896, 717, 615, 599, 656, 599, 492, 597, 317, 370, 577, 370, 577, 810, 598, 721, 680, 702, 690, 647, 496, 629, 629, 545, 496, 601, 629, 545, 482, 599,
+        278, 465, 433, 279, 1342, 1226, 1090, 789, 743, 431, 879, 872, 753, 646, 579, 278, 262, 743, 578, 691, 598, 691, 598, 691, 598, 691, 598, 691, 598, 581, 646, 579,
+        646, 579, 920, 927, 732, 599, 732, 599, 619, 547, 743, 578, 743, 578, 629, 545, 262, 1342, 1226, 1090, 732, 599, 1051, 644, 706, 598, 646, 579, 920, 927, 743, 578,
+    }, {
+        646, 579, 646, 579, 597, 581, 597, 581, 278, 262, 278, 262, 743, 578, 743, 578, 656, 388, 656, 388, 691, 598, 691, 598, 667, 500, 577, 370, 592, 492, 710, 598,
+        694, 791, 659, 576, 647, 496, 646, 579, 597, 581, 743, 578, 743, 578, 743, 578, 743, 578, 577, 559, 448, 796, 450, 262, 942, 942, 646, 659, 519, 526, 577, 492,
+        496, 569, 452, 648, 691, 646, 597, 581, 278, 262, 738, 599, 656, 388, 577, 559, 567, 599, 599, 599, 519, 519, 599, 657, 581, 581, 774, 510, 502, 732, 627, 262,
+        657, 599, 594, 562, 562, 598, 598, 598, 262, 319, 351, 373, 460, 263, 667, 920, 920, 920, 610, 606, 598, 578, 810, 687, 623, 391, 391, 390, 388, 388, 501, 501,
+        570, 570, 492, 317, 317, 436, 317, 370, 370, 598, 583, 565, 559, 772, 559, 577, 496, 496, 545, 545, 482, 482, 482, 482, 743, 547, 627, 668, 617, 276, 630, 479,
+        686, 482, 482, 957, 998, 956, 784, 576, 735, 801, 666, 618, 486, 486, 624, 626, 382, 377, 165, 244, 279, 279, 358, 486, 352, 263, 434, 300, 300, 300, 290, 290,
+        349, 349, 472, 472, 472, 472, 333, 333, 260, 472, 472, 472, 260, 472, 472, 472, 318, 318, 290, 290, 472, 472, 368, 300, 333, 333, 333, 333, 333, 333, 298, 472,
+        402, 157, 352, 419, 349, 466, 466, 466, 466, 466, 489, 489, 472, 472, 489, 489, 489, 489, 489, 472, 489, 489, 489, 472, 489, 489, 489, 489, 489, 489, 489, 489,
+    }, {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 618, 536, 814, 611, 263, 263, 706, 614, 489, 489, 472, 519, 519, 519, 318, 489,
+        489, 489, 489, 489, 472, 472, 654, 300, 704, 822, 385, 489, 767, 489, 779, 780, 319, 646, 648, 526, 646, 597, 647, 710, 743, 278, 619, 646, 815, 706, 597, 743,
+        710, 569, 489, 597, 577, 577, 743, 647, 743, 721, 278, 577, 622, 510, 598, 319, 546, 622, 603, 559, 578, 510, 514, 598, 578, 319, 556, 559, 601, 527, 526, 578,
+        568, 599, 554, 598, 568, 546, 623, 545, 623, 791, 319, 546, 578, 546, 791, 619, 580, 585, 660, 795, 660, 623, 791, 626, 743, 578, 612, 554, 543, 433, 623, 623,
+        817, 592, 881, 791, 716, 622, 747, 580, 648, 573, 725, 590, 660, 578, 577, 506, 626, 599, 519, 262, 743, 581, 581, 571, 599, 659, 815, 614, 599, 664, 659, 664,
+    }, {
+        597, 597, 742, 576, 659, 599, 278, 278, 278, 1033, 987, 742, 670, 706, 575, 710, 646, 648, 648, 576, 738, 597, 1017, 605, 706, 706, 670, 710, 815, 710, 743, 710,
+        569, 659, 577, 575, 813, 647, 733, 647, 1010, 1033, 786, 833, 648, 659, 1019, 656, 579, 582, 556, 496, 653, 581, 851, 502, 614, 614, 570, 603, 712, 617, 578, 617,
+        599, 519, 550, 559, 807, 559, 643, 558, 864, 889, 667, 745, 556, 518, 795, 568, 581, 581, 590, 496, 518, 492, 262, 262, 262, 852, 848, 615, 570, 614, 559, 617,
+        881, 791, 727, 634, 890, 707, 830, 739, 1095, 945, 743, 578, 969, 778, 601, 510, 809, 827, 743, 578, 738, 628, 738, 628, 937, 854, 900, 716, 1114, 970, 881, 791,
+        659, 519, 474, 0, 0, 0, 0, 0, 0, 0, 729, 639, 648, 556, 569, 599, 576, 496, 637, 557, 589, 500, 1017, 851, 605, 502, 670, 570, 670, 570, 670, 570,
+        809, 785, 710, 624, 957, 828, 1021, 864, 829, 654, 659, 519, 577, 550, 577, 559, 577, 559, 647, 559, 882, 762, 647, 558, 647, 558, 647, 598, 888, 687, 888, 687,
+        278, 1017, 851, 619, 570, 733, 633, 710, 624, 733, 643, 647, 558, 838, 731, 262, 646, 579, 646, 579, 920, 927, 597, 581, 743, 581, 743, 581, 1017, 851, 605, 502,
+        629, 545, 706, 614, 706, 614, 743, 578, 743, 578, 743, 578, 659, 518, 575, 559, 575, 559, 575, 559, 647, 558, 576, 496, 833, 745, 637, 557, 647, 559, 647, 559,
+    }, {
+        648, 556, 950, 847, 920, 821, 641, 555, 1012, 904, 1051, 913, 732, 623, 730, 671, 580, 510, 710, 603, 1104, 938, 844, 816, 974, 931, 743, 599, 934, 772, 670, 570,
+        1020, 855, 1021, 861, 749, 644, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 723, 691, 711, 711, 691, 729, 604, 691, 811, 711, 652, 503, 870, 815, 691,
+        676, 723, 711, 724, 747, 687, 688, 715, 691, 673, 756, 725, 747, 691, 711, 666, 655, 702, 508, 765, 715, 743, 746, 489, 489, 290, 300, 221, 341, 225, 383, 472,
+        489, 920, 598, 621, 626, 598, 599, 486, 598, 697, 621, 598, 256, 925, 588, 598, 598, 574, 599, 594, 598, 256, 598, 471, 598, 382, 920, 529, 612, 598, 598, 919,
+        598, 598, 410, 919, 601, 575, 760, 766, 489, 318, 341, 489, 489, 489, 489, 489, 489, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 341, 0,
+        278, 0, 0, 278, 0, 0, 417, 0, 489, 489, 489, 489, 489, 489, 489, 489, 631, 546, 389, 515, 617, 257, 327, 617, 612, 211, 507, 499, 537, 626, 641, 257,
+        378, 613, 591, 604, 590, 509, 560, 670, 533, 669, 620, 489, 489, 489, 489, 489, 444, 399, 312, 392, 609, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489,
+    }, {
+        646, 579, 648, 599, 648, 599, 648, 599, 659, 519, 727, 599, 727, 599, 727, 599, 727, 599, 727, 599, 597, 581, 597, 581, 597, 581, 597, 581, 597, 581, 543, 332,
+        732, 599, 710, 598, 710, 598, 710, 598, 710, 598, 710, 598, 278, 262, 278, 262, 619, 547, 619, 547, 619, 547, 526, 272, 526, 272, 526, 262, 526, 262, 815, 920,
+        815, 920, 815, 920, 706, 598, 706, 598, 706, 598, 706, 598, 743, 578, 743, 578, 743, 578, 743, 578, 569, 599, 569, 599, 656, 388, 656, 388, 656, 388, 656, 388,
+        599, 492, 599, 492, 599, 492, 599, 492, 599, 492, 577, 370, 577, 370, 577, 370, 577, 370, 691, 598, 691, 598, 691, 598, 691, 598, 691, 598, 646, 559, 646, 559,
+        934, 772, 934, 772, 934, 772, 934, 772, 934, 772, 647, 559, 647, 559, 577, 559, 647, 496, 647, 496, 647, 496, 598, 370, 772, 559, 579, 332, 332, 332, 726, 578,
+        646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 646, 579, 597, 581, 597, 581, 597, 581, 597, 581,
+        597, 581, 597, 581, 597, 581, 597, 581, 278, 262, 278, 262, 743, 578, 743, 578, 743, 578, 743, 578, 743, 578, 743, 578, 743, 578, 862, 578, 862, 578, 862, 578,
+        862, 578, 862, 578, 691, 598, 691, 598, 810, 598, 810, 598, 810, 598, 810, 598, 810, 598, 577, 559, 577, 559, 577, 559, 577, 559, 726, 450, 489, 489, 489, 489,
+    }, {
+        472, 944, 472, 944, 311, 236, 158, 601, 300, 189, 94, 0, 0, 0, 0, 0, 341, 341, 601, 556, 1000, 944, 472, 472, 222, 222, 222, 300, 333, 333, 333, 489,
+        556, 556, 350, 557, 316, 630, 1000, 300, 0, 0, 0, 0, 0, 0, 0, 189, 1000, 1638, 214, 353, 491, 214, 353, 491, 320, 333, 333, 791, 458, 501, 472, 759,
+        759, 236, 944, 472, 167, 368, 368, 870, 692, 692, 469, 601, 472, 472, 472, 318, 759, 472, 425, 944, 759, 791, 553, 626, 791, 791, 300, 753, 791, 300, 300, 210,
+        0, 0, 0, 0, 0, 489, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 378, 169, 489, 489, 378, 378, 378, 378, 378, 378, 498, 498, 498, 232, 232, 376,
+        378, 378, 378, 378, 378, 378, 378, 378, 378, 378, 498, 498, 498, 232, 232, 489, 370, 394, 390, 419, 394, 382, 402, 157, 588, 376, 404, 352, 278, 489, 489, 489,
+        828, 601, 601, 601, 601, 920, 601, 1201, 1014, 934, 740, 601, 556, 601, 601, 1201, 601, 601, 601, 601, 731, 601, 489, 489, 601, 601, 601, 489, 489, 601, 489, 489,
+        489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489,
+    }, {
+        962, 962, 659, 1060, 606, 962, 1007, 580, 659, 898, 489, 933, 712, 802, 598, 598, 443, 658, 680, 390, 772, 756, 982, 944, 658, 662, 743, 753, 768, 748, 846, 646,
+        963, 1014, 1000, 646, 703, 545, 721, 721, 582, 319, 619, 646, 742, 664, 807, 559, 572, 742, 543, 1010, 436, 703, 636, 440, 609, 359, 874, 1127, 663, 687, 618, 801,
+        765, 732, 526, 526, 577, 773, 668, 581, 331, 331, 489, 736, 489, 489, 497, 489, 915, 915, 1294, 915, 915, 915, 915, 915, 915, 915, 915, 915, 915, 915, 915, 536,
+        278, 465, 651, 871, 646, 871, 1057, 1243, 866, 647, 881, 1068, 526, 659, 727, 815, 262, 432, 602, 766, 559, 766, 935, 1105, 773, 559, 776, 946, 262, 519, 599, 920,
+        1176, 727, 1176, 664, 519, 659, 489, 489, 489, 915, 489, 489, 489, 489, 489, 489, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+        791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+        791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+        791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+    }}}, 489, fontWideAdvance};
+
+// Times, whose advances Times New Roman matches.
+inline constexpr FontMetrics serifFontMetrics = {{{
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        250, 333, 408, 500, 500, 833, 778, 180, 333, 333, 500, 564, 250, 333, 250, 278, 500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 278, 278, 564, 564, 564, 444,
+        921, 722, 667, 667, 722, 611, 556, 722, 722, 333, 389, 722, 611, 889, 722, 722, 556, 722, 667, 556, 611, 722, 722, 944, 722, 722, 611, 333, 278, 333, 469, 500,
+        333, 444, 500, 444, 500, 444, 333, 500, 500, 278, 278, 500, 278, 778, 500, 500, 500, 500, 333, 389, 278, 500, 500, 722, 500, 500, 444, 480, 200, 480, 541, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        273, 333, 500, 500, 500, 500, 200, 500, 333, 760, 276, 500, 564, 0, 760, 333, 400, 564, 300, 300, 333, 500, 453, 250, 333, 300, 310, 500, 750, 750, 750, 444,
+        722, 722, 722, 722, 722, 722, 889, 667, 611, 611, 611, 611, 333, 333, 333, 333, 722, 722, 722, 722, 722, 722, 722, 564, 722, 722, 722, 722, 722, 722, 556, 500,
+        444, 444, 444, 444, 444, 444, 667, 444, 444, 444, 444, 444, 278, 278, 278, 278, 500, 500, 500, 500, 500, 500, 500, 564, 500, 500, 500, 500, 500, 500, 500, 500,
+    }, {
+        722, 444, 722, 444, 722, 444, 667, 444, 656, 480, 656, 480, 667, 444, 722, 588, 722, 500, 611, 444, 626, 508, 611, 444, 611, 444, 611, 444, 685, 549, 722, 500,
+        685, 549, 722, 500, 748, 552, 748, 552, 339, 274, 333, 278, 339, 274, 333, 278, 333, 278, 687, 457, 344, 266, 722, 500, 520, 611, 278, 611, 278, 611, 344, 570,
+        274, 611, 278, 722, 500, 722, 500, 722, 500, 743, 723, 552, 722, 500, 703, 516, 722, 500, 889, 722, 667, 333, 667, 333, 667, 333, 556, 389, 588, 440, 556, 389,
+        556, 389, 611, 278, 611, 326, 572, 345, 723, 552, 722, 500, 723, 552, 722, 500, 722, 500, 722, 500, 882, 734, 566, 485, 722, 611, 444, 611, 444, 611, 444, 317,
+        549, 630, 630, 549, 630, 549, 656, 656, 480, 692, 688, 630, 549, 516, 626, 703, 534, 595, 500, 685, 611, 800, 339, 339, 641, 520, 274, 544, 813, 751, 552, 703,
+        703, 516, 892, 692, 577, 549, 646, 588, 440, 606, 278, 345, 572, 345, 572, 723, 552, 711, 652, 633, 568, 596, 452, 484, 484, 484, 484, 546, 589, 484, 460, 544,
+        253, 422, 394, 253, 1284, 1140, 1001, 913, 836, 540, 1094, 1017, 818, 619, 511, 339, 274, 703, 516, 723, 552, 723, 552, 723, 552, 723, 552, 723, 552, 508, 619, 511,
+        619, 511, 859, 806, 727, 549, 685, 549, 641, 520, 703, 516, 703, 516, 484, 484, 274, 1284, 1140, 1001, 685, 549, 990, 606, 751, 552, 619, 511, 859, 806, 703, 516,
+    }, {
+        619, 511, 619, 511, 626, 508, 626, 508, 339, 274, 339, 274, 703, 516, 703, 516, 646, 410, 646, 410, 723, 552, 723, 552, 556, 389, 572, 345, 538, 447, 748, 552,
+        723, 698, 490, 474, 596, 452, 619, 511, 626, 508, 703, 516, 703, 516, 703, 516, 703, 516, 566, 485, 429, 713, 423, 266, 823, 823, 619, 656, 480, 570, 572, 440,
+        452, 501, 398, 630, 723, 619, 626, 508, 344, 270, 671, 549, 646, 410, 566, 485, 511, 549, 549, 549, 480, 480, 555, 586, 508, 508, 723, 444, 436, 663, 526, 270,
+        586, 549, 497, 514, 484, 552, 552, 552, 274, 336, 274, 326, 390, 311, 604, 813, 813, 813, 552, 595, 554, 516, 678, 704, 593, 430, 430, 473, 410, 410, 388, 388,
+        498, 498, 440, 233, 317, 418, 278, 345, 345, 552, 532, 521, 485, 734, 485, 562, 512, 480, 484, 480, 460, 460, 460, 361, 703, 483, 526, 566, 572, 314, 520, 466,
+        586, 460, 460, 854, 886, 856, 706, 513, 708, 766, 622, 580, 513, 380, 670, 658, 371, 369, 227, 298, 298, 369, 336, 502, 363, 239, 395, 273, 273, 273, 263, 263,
+        240, 241, 429, 429, 429, 429, 333, 333, 236, 429, 429, 429, 236, 429, 459, 459, 289, 289, 263, 263, 459, 459, 282, 282, 333, 333, 333, 333, 333, 333, 358, 459,
+        324, 208, 289, 364, 241, 423, 423, 423, 423, 423, 459, 459, 429, 459, 415, 429, 429, 459, 459, 429, 459, 459, 459, 429, 459, 459, 459, 459, 459, 459, 459, 459,
+    }, {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 635, 456, 572, 475, 239, 239, 751, 572, 459, 459, 429, 480, 480, 480, 289, 459,
+        459, 459, 459, 459, 429, 429, 619, 273, 772, 891, 482, 459, 717, 459, 770, 731, 336, 619, 630, 595, 619, 626, 596, 748, 703, 339, 641, 619, 878, 751, 604, 703,
+        748, 577, 459, 606, 572, 566, 703, 611, 752, 711, 339, 566, 579, 444, 514, 336, 521, 579, 496, 513, 516, 444, 465, 514, 516, 336, 536, 544, 557, 521, 472, 516,
+        564, 504, 480, 586, 475, 521, 601, 520, 673, 699, 336, 521, 516, 521, 699, 641, 500, 613, 589, 750, 589, 585, 699, 535, 703, 516, 656, 480, 595, 397, 506, 566,
+        671, 495, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 535, 504, 480, 266, 703, 480, 480, 580, 549, 656, 878, 607, 504, 656, 656, 656,
+    }, {
+        626, 626, 685, 568, 656, 588, 339, 339, 344, 930, 959, 748, 664, 748, 620, 748, 650, 630, 630, 568, 697, 626, 964, 534, 748, 748, 664, 716, 878, 748, 703, 748,
+        577, 656, 572, 620, 712, 611, 748, 663, 979, 979, 681, 844, 578, 656, 1024, 693, 511, 516, 483, 449, 528, 508, 789, 468, 572, 572, 536, 545, 667, 572, 516, 572,
+        549, 480, 475, 505, 671, 484, 552, 567, 797, 797, 546, 683, 467, 480, 747, 541, 508, 508, 535, 449, 480, 440, 274, 274, 266, 723, 738, 552, 536, 572, 505, 563,
+        459, 459, 653, 517, 968, 715, 459, 459, 459, 459, 964, 789, 1166, 955, 459, 459, 810, 774, 703, 474, 737, 582, 737, 582, 459, 459, 459, 459, 459, 459, 459, 459,
+        459, 459, 459, 0, 0, 0, 0, 0, 0, 0, 459, 459, 606, 467, 459, 459, 576, 454, 568, 449, 624, 526, 964, 789, 546, 460, 664, 520, 459, 459, 664, 536,
+        764, 615, 748, 550, 977, 731, 1034, 807, 459, 459, 656, 480, 572, 475, 566, 485, 566, 485, 611, 484, 816, 628, 643, 592, 459, 459, 643, 552, 459, 459, 459, 459,
+        339, 964, 789, 641, 520, 459, 459, 748, 572, 459, 459, 643, 572, 459, 459, 274, 650, 511, 650, 511, 859, 806, 626, 508, 703, 508, 703, 508, 964, 789, 534, 468,
+        484, 484, 748, 572, 748, 572, 703, 516, 703, 516, 703, 516, 656, 480, 620, 505, 620, 505, 620, 505, 663, 567, 568, 449, 844, 683, 459, 459, 459, 459, 459, 459,
+    }, {
+        459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 534, 468, 716, 545, 1027, 788, 459, 459, 459, 459, 703, 549, 882, 734, 459, 459,
+        459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 695, 696, 708, 727, 692, 709, 653, 696, 830, 700, 663, 585, 941, 725, 689,
+        617, 695, 715, 723, 770, 655, 681, 647, 685, 684, 750, 712, 758, 685, 688, 627, 664, 643, 543, 725, 723, 716, 704, 459, 459, 263, 226, 197, 335, 312, 331, 429,
+        459, 814, 530, 596, 596, 539, 590, 437, 545, 678, 575, 544, 261, 834, 527, 539, 545, 541, 545, 561, 552, 265, 545, 395, 557, 313, 807, 482, 564, 552, 540, 797,
+        552, 551, 415, 797, 545, 523, 694, 676, 459, 292, 286, 459, 459, 459, 459, 459, 459, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 459, 0,
+        459, 0, 0, 459, 0, 0, 459, 0, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459,
+        459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459,
+    }, {
+        619, 511, 630, 549, 630, 549, 630, 549, 656, 480, 688, 549, 688, 549, 688, 549, 688, 549, 688, 549, 626, 508, 626, 508, 626, 508, 626, 508, 626, 508, 595, 317,
+        685, 549, 748, 552, 748, 552, 748, 552, 748, 552, 748, 552, 339, 274, 339, 274, 641, 520, 641, 520, 641, 520, 570, 274, 570, 274, 570, 274, 570, 274, 878, 813,
+        878, 813, 878, 813, 751, 552, 751, 552, 751, 552, 751, 552, 703, 516, 703, 516, 703, 516, 703, 516, 577, 549, 577, 549, 646, 410, 646, 410, 646, 410, 646, 410,
+        588, 440, 588, 440, 588, 440, 588, 447, 588, 440, 572, 345, 572, 345, 572, 345, 572, 345, 723, 552, 723, 552, 723, 552, 723, 552, 723, 552, 619, 485, 619, 485,
+        882, 734, 882, 734, 882, 734, 882, 734, 882, 734, 611, 484, 611, 484, 566, 485, 596, 452, 596, 452, 596, 452, 552, 345, 734, 485, 775, 317, 317, 317, 711, 516,
+        619, 511, 619, 511, 619, 526, 619, 526, 619, 526, 619, 526, 619, 511, 619, 511, 619, 511, 619, 511, 619, 511, 619, 511, 626, 508, 626, 508, 626, 508, 626, 528,
+        626, 528, 626, 528, 626, 528, 626, 508, 339, 274, 339, 274, 703, 516, 703, 516, 703, 525, 703, 525, 703, 525, 703, 525, 703, 516, 703, 516, 703, 516, 703, 516,
+        703, 516, 703, 516, 723, 552, 723, 552, 723, 552, 723, 552, 723, 552, 723, 552, 723, 552, 566, 485, 566, 485, 566, 485, 566, 485, 814, 498, 459, 459, 459, 459,
+    }, {
+        429, 858, 429, 858, 283, 214, 143, 546, 273, 171, 85, 0, 0, 0, 0, 0, 290, 290, 546, 500, 1000, 858, 429, 429, 333, 333, 333, 273, 444, 444, 444, 439,
+        500, 500, 350, 506, 286, 572, 1000, 459, 459, 459, 0, 0, 0, 0, 0, 171, 1000, 1487, 195, 320, 446, 195, 320, 446, 291, 333, 333, 459, 452, 460, 429, 459,
+        459, 459, 858, 459, 167, 335, 335, 837, 646, 646, 459, 546, 429, 429, 429, 289, 459, 429, 386, 858, 459, 459, 459, 569, 459, 459, 459, 459, 459, 459, 459, 191,
+        0, 0, 0, 0, 0, 459, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 344, 173, 459, 459, 344, 344, 344, 344, 344, 344, 453, 453, 453, 211, 211, 371,
+        344, 344, 344, 344, 344, 344, 344, 344, 344, 344, 453, 453, 453, 211, 211, 459, 331, 332, 330, 364, 332, 371, 313, 208, 526, 371, 343, 289, 212, 459, 459, 459,
+        459, 459, 459, 459, 459, 459, 546, 459, 459, 459, 459, 459, 500, 459, 459, 907, 459, 606, 459, 459, 669, 546, 459, 459, 546, 546, 546, 459, 459, 546, 459, 459,
+        459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459, 459,
+    }, {
+        459, 459, 683, 960, 459, 459, 459, 459, 459, 898, 459, 459, 459, 810, 552, 552, 459, 459, 459, 459, 459, 784, 812, 459, 459, 645, 747, 459, 459, 713, 459, 459,
+        459, 459, 980, 459, 626, 459, 711, 711, 459, 459, 641, 619, 459, 459, 459, 459, 459, 459, 595, 459, 459, 459, 459, 459, 459, 459, 459, 459, 628, 566, 609, 810,
+        612, 665, 478, 478, 524, 744, 600, 546, 326, 310, 459, 764, 459, 459, 441, 459, 831, 831, 1175, 831, 831, 831, 831, 831, 831, 831, 831, 831, 831, 831, 831, 487,
+        339, 506, 674, 829, 619, 841, 1009, 1177, 799, 611, 800, 967, 570, 656, 688, 878, 274, 549, 823, 759, 485, 759, 1033, 1308, 758, 484, 758, 1032, 274, 480, 549, 813,
+        1035, 688, 1035, 656, 480, 656, 459, 459, 459, 831, 459, 459, 459, 459, 459, 459, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719,
+        719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719,
+        719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719,
+        719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719, 719,
+    }}}, 459, fontWideAdvance};
+
+// Zapf Chancery, the chancery italic closest to Monotype Corsiva.
+inline constexpr FontMetrics cursiveFontMetrics = {{{
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        220, 280, 220, 440, 440, 680, 780, 160, 260, 220, 420, 520, 220, 280, 220, 340, 440, 440, 440, 440, 440, 440, 440, 440, 440, 440, 260, 240, 520, 520, 520, 380,
+        700, 620, 600, 520, 700, 620, 580, 620, 680, 380, 400, 660, 580, 840, 700, 600, 540, 600, 600, 460, 500, 740, 640, 880, 560, 560, 620, 240, 480, 320, 520, 500,
+        220, 420, 420, 340, 440, 340, 320, 400, 440, 240, 220, 440, 240, 620, 460, 400, 440, 400, 300, 320, 320, 460, 440, 680, 420, 400, 440, 240, 520, 240, 520, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        244, 280, 440, 440, 440, 440, 520, 420, 360, 740, 260, 340, 520, 0, 740, 440, 400, 520, 264, 264, 300, 460, 500, 220, 300, 264, 260, 380, 660, 660, 660, 400,
+        620, 620, 620, 620, 620, 620, 740, 520, 620, 620, 620, 620, 380, 380, 380, 380, 700, 700, 600, 600, 600, 600, 600, 520, 660, 740, 740, 740, 740, 560, 540, 420,
+        420, 420, 420, 420, 420, 420, 540, 340, 340, 340, 340, 340, 240, 240, 240, 240, 400, 460, 400, 400, 400, 400, 400, 520, 440, 460, 460, 460, 460, 400, 440, 400,
+    }, {
+        554, 457, 554, 457, 554, 457, 586, 429, 586, 429, 586, 429, 586, 429, 615, 491, 619, 491, 560, 454, 560, 454, 560, 454, 560, 454, 560, 454, 612, 491, 612, 491,
+        612, 491, 612, 491, 668, 494, 668, 494, 303, 245, 303, 245, 303, 245, 303, 245, 303, 240, 614, 409, 307, 238, 573, 464, 464, 509, 245, 509, 245, 509, 307, 515,
+        356, 580, 300, 671, 494, 671, 494, 671, 494, 664, 646, 494, 628, 461, 628, 461, 628, 461, 820, 560, 577, 366, 577, 366, 577, 366, 525, 393, 525, 393, 525, 393,
+        460, 320, 511, 308, 511, 308, 511, 308, 646, 494, 646, 494, 646, 494, 646, 494, 646, 494, 646, 494, 788, 656, 506, 433, 560, 533, 404, 533, 404, 620, 440, 284,
+        491, 563, 563, 491, 563, 491, 586, 586, 429, 619, 615, 563, 491, 461, 560, 628, 478, 532, 440, 612, 546, 714, 303, 303, 573, 464, 245, 486, 727, 671, 494, 628,
+        628, 461, 797, 619, 516, 491, 577, 525, 393, 542, 249, 308, 511, 308, 511, 646, 494, 636, 582, 566, 571, 533, 404, 433, 433, 433, 433, 488, 526, 433, 411, 487,
+        226, 377, 352, 226, 1147, 1018, 895, 816, 747, 483, 978, 908, 731, 554, 457, 303, 245, 628, 461, 646, 494, 646, 494, 646, 494, 646, 494, 646, 494, 454, 554, 457,
+        554, 457, 767, 720, 650, 491, 612, 491, 573, 464, 628, 461, 628, 461, 433, 433, 245, 1147, 1018, 895, 612, 491, 884, 542, 671, 494, 554, 457, 767, 720, 628, 461,
+    }, {
+        554, 457, 554, 457, 560, 454, 560, 454, 303, 245, 303, 245, 628, 461, 628, 461, 577, 366, 577, 366, 646, 494, 646, 494, 525, 393, 511, 308, 481, 400, 668, 494,
+        646, 624, 438, 423, 533, 404, 554, 457, 560, 454, 628, 461, 628, 461, 628, 461, 628, 461, 506, 433, 384, 637, 378, 238, 736, 736, 554, 586, 429, 509, 511, 393,
+        404, 447, 356, 563, 646, 554, 560, 454, 307, 241, 600, 491, 577, 366, 506, 433, 457, 518, 518, 491, 429, 429, 496, 523, 454, 454, 646, 411, 390, 592, 470, 241,
+        524, 491, 444, 459, 432, 494, 494, 494, 245, 301, 245, 292, 348, 278, 540, 727, 727, 727, 493, 532, 495, 461, 606, 630, 530, 384, 384, 423, 366, 366, 347, 347,
+        445, 445, 393, 208, 284, 373, 249, 308, 308, 494, 475, 466, 433, 656, 433, 502, 458, 429, 433, 429, 411, 411, 411, 322, 628, 432, 470, 506, 511, 280, 464, 416,
+        524, 411, 411, 764, 792, 765, 631, 458, 633, 685, 555, 518, 458, 339, 598, 588, 332, 329, 202, 266, 266, 330, 300, 413, 272, 213, 353, 244, 244, 244, 235, 235,
+        215, 215, 383, 383, 383, 383, 340, 340, 216, 383, 383, 383, 216, 383, 398, 398, 258, 258, 235, 235, 398, 398, 301, 301, 440, 220, 300, 280, 440, 400, 320, 398,
+        289, 186, 258, 272, 215, 378, 378, 378, 378, 378, 398, 398, 383, 398, 371, 383, 383, 398, 398, 383, 398, 398, 398, 383, 398, 398, 398, 398, 398, 398, 398, 398,
+    }, {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 567, 407, 511, 424, 213, 213, 671, 511, 398, 398, 383, 429, 429, 429, 258, 398,
+        398, 398, 398, 398, 383, 383, 554, 244, 690, 796, 431, 398, 640, 398, 688, 653, 301, 554, 563, 532, 554, 560, 533, 668, 628, 303, 573, 554, 785, 671, 539, 628,
+        668, 516, 398, 542, 511, 506, 628, 546, 672, 636, 303, 506, 518, 411, 459, 301, 466, 518, 443, 458, 461, 411, 415, 459, 461, 301, 503, 486, 498, 466, 422, 461,
+        504, 451, 429, 523, 424, 466, 537, 464, 601, 625, 301, 466, 461, 466, 625, 573, 447, 548, 526, 670, 526, 522, 625, 478, 628, 461, 586, 429, 532, 355, 452, 506,
+        600, 442, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 478, 451, 429, 238, 628, 429, 429, 518, 491, 586, 785, 543, 451, 586, 586, 586,
+    }, {
+        560, 560, 612, 508, 586, 525, 303, 303, 307, 831, 857, 668, 593, 668, 554, 668, 581, 563, 563, 508, 623, 560, 861, 478, 668, 668, 593, 640, 785, 668, 628, 668,
+        516, 586, 511, 554, 636, 546, 668, 592, 875, 875, 609, 754, 517, 586, 915, 619, 457, 468, 446, 387, 486, 454, 871, 418, 494, 494, 458, 488, 636, 505, 461, 494,
+        491, 429, 727, 445, 600, 432, 535, 477, 726, 767, 511, 624, 417, 429, 675, 508, 454, 454, 478, 387, 429, 393, 245, 245, 238, 659, 673, 494, 458, 494, 445, 494,
+        398, 398, 584, 676, 865, 639, 398, 398, 398, 398, 861, 705, 1042, 814, 398, 398, 723, 692, 628, 423, 659, 520, 659, 520, 398, 398, 398, 398, 398, 398, 398, 398,
+        398, 398, 398, 0, 0, 0, 0, 0, 0, 0, 398, 398, 542, 417, 398, 398, 515, 405, 508, 387, 560, 470, 861, 871, 478, 418, 593, 463, 398, 398, 593, 458,
+        684, 513, 668, 546, 873, 657, 924, 723, 398, 398, 586, 429, 511, 776, 506, 438, 506, 438, 546, 482, 717, 561, 574, 519, 398, 398, 574, 494, 398, 398, 398, 398,
+        303, 861, 871, 573, 464, 398, 398, 668, 511, 398, 398, 574, 511, 398, 398, 245, 581, 457, 581, 457, 767, 720, 560, 454, 628, 454, 628, 454, 861, 871, 478, 418,
+        433, 433, 668, 494, 668, 494, 628, 461, 628, 461, 628, 461, 586, 429, 554, 445, 554, 445, 554, 445, 592, 477, 508, 387, 754, 624, 398, 398, 398, 398, 398, 398,
+    }, {
+        398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 478, 418, 640, 488, 919, 720, 398, 398, 398, 398, 628, 491, 788, 656, 398, 398,
+        398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 621, 622, 618, 634, 618, 633, 583, 622, 742, 625, 592, 523, 841, 647, 616,
+        551, 621, 639, 637, 688, 585, 609, 578, 612, 611, 670, 636, 662, 612, 615, 561, 594, 574, 485, 648, 646, 640, 629, 398, 398, 235, 202, 176, 299, 279, 296, 383,
+        398, 727, 473, 533, 533, 481, 527, 391, 487, 606, 514, 487, 234, 746, 471, 481, 487, 483, 487, 501, 494, 237, 487, 353, 497, 280, 721, 430, 504, 494, 483, 713,
+        494, 493, 371, 713, 487, 467, 620, 604, 398, 260, 256, 398, 398, 398, 398, 398, 398, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 398, 0,
+        398, 0, 0, 398, 0, 0, 398, 0, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398,
+        398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398,
+    }, {
+        554, 457, 563, 491, 563, 491, 563, 491, 586, 429, 615, 491, 615, 491, 615, 491, 615, 491, 615, 491, 560, 454, 560, 454, 560, 454, 560, 454, 560, 454, 532, 284,
+        612, 491, 668, 494, 668, 494, 668, 494, 668, 494, 668, 494, 303, 245, 303, 245, 573, 464, 573, 464, 573, 464, 509, 245, 509, 245, 509, 245, 509, 245, 785, 727,
+        785, 727, 785, 731, 671, 494, 671, 494, 671, 494, 671, 494, 628, 461, 628, 461, 628, 461, 628, 461, 516, 491, 516, 491, 577, 366, 577, 366, 577, 366, 577, 366,
+        525, 393, 525, 393, 525, 393, 525, 399, 525, 393, 511, 308, 511, 308, 511, 308, 511, 308, 646, 494, 646, 494, 646, 494, 646, 494, 646, 494, 554, 433, 554, 433,
+        788, 656, 788, 656, 788, 656, 788, 656, 788, 656, 546, 432, 546, 432, 506, 433, 533, 404, 533, 404, 533, 404, 494, 308, 656, 433, 692, 284, 284, 284, 636, 461,
+        554, 457, 554, 457, 554, 470, 554, 470, 554, 470, 554, 470, 554, 457, 554, 457, 554, 457, 554, 457, 554, 457, 554, 457, 560, 454, 560, 454, 560, 454, 560, 472,
+        560, 472, 560, 472, 560, 472, 560, 454, 303, 245, 303, 245, 628, 461, 628, 461, 628, 469, 628, 469, 628, 469, 628, 469, 628, 461, 628, 461, 628, 461, 628, 461,
+        628, 461, 628, 461, 646, 494, 646, 494, 646, 494, 646, 494, 646, 494, 646, 494, 646, 494, 506, 433, 506, 433, 506, 433, 506, 433, 727, 445, 398, 398, 398, 398,
+    }, {
+        383, 767, 383, 767, 253, 192, 128, 488, 244, 153, 76, 0, 0, 0, 0, 0, 259, 259, 488, 500, 1000, 767, 383, 383, 240, 240, 180, 244, 340, 360, 280, 392,
+        460, 480, 600, 452, 256, 511, 1000, 398, 398, 398, 0, 0, 0, 0, 0, 153, 960, 1329, 174, 286, 399, 174, 286, 399, 260, 240, 260, 398, 404, 411, 383, 398,
+        398, 398, 767, 398, 60, 299, 299, 748, 578, 578, 398, 488, 383, 383, 383, 258, 398, 383, 345, 767, 398, 398, 398, 508, 398, 398, 398, 398, 398, 398, 398, 170,
+        0, 0, 0, 0, 0, 398, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 307, 154, 398, 398, 307, 307, 307, 307, 307, 307, 405, 405, 405, 188, 188, 311,
+        307, 307, 307, 307, 307, 307, 307, 307, 307, 307, 405, 405, 405, 188, 188, 398, 288, 297, 295, 272, 297, 332, 280, 186, 470, 311, 307, 258, 189, 398, 398, 398,
+        398, 398, 398, 398, 398, 398, 488, 398, 398, 398, 398, 398, 488, 398, 398, 810, 398, 541, 398, 398, 598, 488, 398, 398, 488, 488, 488, 398, 398, 488, 398, 398,
+        398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398,
+    }, {
+        398, 398, 398, 857, 398, 398, 398, 398, 398, 803, 398, 398, 398, 398, 494, 494, 398, 398, 398, 398, 398, 398, 725, 398, 398, 398, 398, 398, 398, 398, 398, 398,
+        398, 398, 1000, 398, 398, 398, 636, 636, 398, 398, 573, 554, 398, 398, 398, 398, 398, 398, 532, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398, 398,
+        398, 594, 427, 427, 468, 398, 398, 398, 398, 398, 398, 682, 398, 398, 394, 398, 743, 743, 1050, 743, 743, 743, 743, 743, 743, 743, 743, 743, 743, 743, 743, 435,
+        303, 452, 602, 741, 554, 752, 902, 1051, 714, 546, 714, 864, 509, 586, 615, 785, 245, 490, 735, 678, 433, 678, 923, 1168, 677, 432, 677, 923, 245, 429, 491, 727,
+        924, 615, 924, 586, 429, 586, 398, 398, 398, 743, 398, 398, 398, 398, 398, 398, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642,
+        642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642,
+        642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642,
+        642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642, 642,
+    }}}, 398, fontWideAdvance};
+
+// Helvetica with small capitals made from the capitals at 70% size, as browsers do.
+inline constexpr FontMetrics smallCapsFontMetrics = {{{
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333, 278, 278, 556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556,
+        1015, 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778, 667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 278, 278, 278, 469, 556,
+        333, 467, 467, 505, 505, 467, 428, 545, 505, 195, 350, 467, 389, 583, 505, 545, 467, 545, 505, 467, 428, 505, 467, 661, 467, 467, 428, 334, 260, 334, 584, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        300, 333, 556, 556, 556, 556, 260, 556, 333, 737, 370, 556, 584, 0, 737, 333, 400, 584, 333, 333, 333, 570, 537, 278, 333, 333, 365, 556, 834, 834, 834, 611,
+        667, 667, 667, 667, 667, 667, 1000, 722, 667, 667, 667, 667, 278, 278, 278, 278, 722, 722, 778, 778, 778, 778, 778, 584, 778, 722, 722, 722, 722, 667, 667, 611,
+        467, 467, 467, 467, 467, 467, 700, 505, 467, 467, 467, 467, 195, 195, 195, 195, 505, 505, 545, 545, 545, 545, 545, 584, 545, 505, 505, 505, 505, 467, 467, 467,
+    }, {
+        667, 467, 667, 467, 667, 467, 722, 505, 659, 461, 659, 461, 722, 505, 722, 505, 722, 505, 667, 467, 597, 418, 667, 467, 667, 467, 667, 467, 732, 512, 778, 545,
+        732, 512, 778, 545, 710, 497, 865, 606, 278, 195, 278, 195, 278, 195, 278, 195, 278, 195, 557, 390, 278, 195, 667, 467, 547, 556, 389, 556, 389, 556, 389, 526,
+        368, 556, 389, 722, 505, 722, 505, 722, 505, 768, 706, 494, 778, 545, 743, 520, 778, 545, 1000, 700, 722, 505, 722, 505, 722, 505, 667, 467, 599, 419, 667, 467,
+        667, 467, 611, 428, 611, 428, 577, 404, 691, 484, 722, 505, 691, 484, 722, 505, 722, 505, 722, 505, 934, 654, 577, 404, 667, 611, 428, 611, 428, 611, 428, 467,
+        454, 694, 648, 454, 648, 454, 664, 659, 461, 732, 773, 648, 454, 578, 597, 743, 580, 543, 380, 732, 648, 736, 334, 278, 704, 493, 368, 559, 920, 706, 486, 743,
+        862, 603, 896, 627, 615, 430, 656, 599, 419, 597, 317, 370, 577, 404, 577, 810, 567, 721, 680, 702, 491, 647, 453, 629, 629, 440, 496, 601, 629, 440, 482, 451,
+        278, 465, 433, 279, 1342, 1226, 939, 789, 743, 552, 879, 872, 615, 646, 452, 278, 195, 743, 520, 691, 484, 691, 484, 691, 484, 691, 484, 691, 484, 418, 646, 452,
+        646, 452, 920, 644, 732, 512, 732, 512, 619, 433, 743, 520, 743, 520, 629, 440, 262, 1342, 1226, 939, 732, 512, 1051, 644, 706, 494, 646, 452, 920, 644, 743, 520,
+    }, {
+        646, 452, 646, 452, 597, 418, 597, 418, 278, 195, 278, 195, 743, 520, 743, 520, 656, 459, 656, 459, 691, 484, 691, 484, 667, 467, 577, 404, 592, 414, 710, 497,
+        694, 791, 659, 461, 647, 453, 646, 452, 597, 418, 743, 520, 743, 520, 743, 520, 743, 520, 577, 404, 448, 796, 450, 262, 942, 942, 646, 659, 461, 526, 577, 492,
+        496, 569, 398, 648, 691, 646, 597, 418, 278, 195, 738, 517, 656, 459, 577, 404, 567, 599, 599, 486, 465, 519, 512, 541, 581, 520, 774, 406, 502, 732, 627, 262,
+        512, 599, 594, 454, 562, 598, 598, 598, 195, 234, 351, 373, 460, 263, 667, 644, 920, 920, 494, 606, 598, 520, 810, 687, 623, 391, 391, 390, 388, 388, 501, 501,
+        459, 570, 492, 418, 317, 436, 317, 370, 404, 484, 505, 476, 452, 772, 559, 577, 496, 496, 440, 545, 482, 482, 482, 482, 743, 547, 627, 668, 617, 276, 630, 479,
+        686, 482, 482, 957, 998, 956, 784, 576, 735, 801, 666, 618, 486, 486, 624, 626, 382, 377, 165, 244, 279, 279, 358, 486, 352, 263, 434, 300, 300, 300, 290, 290,
+        349, 349, 472, 472, 472, 472, 333, 333, 260, 472, 472, 472, 260, 472, 472, 472, 318, 318, 290, 290, 472, 472, 368, 300, 333, 333, 333, 333, 333, 333, 298, 472,
+        402, 157, 352, 419, 349, 466, 466, 466, 466, 466, 489, 489, 472, 472, 489, 489, 489, 489, 489, 472, 489, 489, 489, 472, 489, 489, 489, 489, 489, 489, 489, 489,
+    }, {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 618, 433, 814, 570, 263, 263, 706, 494, 489, 489, 472, 465, 461, 465, 318, 489,
+        489, 489, 489, 489, 472, 472, 654, 300, 704, 822, 385, 489, 767, 489, 779, 780, 319, 646, 648, 526, 646, 597, 647, 710, 743, 278, 619, 646, 815, 706, 597, 743,
+        710, 569, 489, 597, 577, 577, 743, 647, 743, 721, 278, 577, 458, 493, 575, 270, 546, 452, 454, 368, 452, 418, 453, 497, 520, 195, 433, 452, 570, 494, 418, 520,
+        497, 398, 418, 418, 404, 404, 520, 453, 520, 505, 195, 404, 537, 545, 546, 619, 454, 520, 660, 795, 660, 520, 497, 433, 743, 520, 612, 428, 543, 380, 623, 436,
+        817, 572, 881, 617, 716, 501, 747, 523, 648, 454, 725, 507, 660, 462, 577, 404, 433, 398, 461, 342, 743, 418, 581, 571, 400, 659, 815, 570, 599, 664, 659, 664,
+    }, {
+        597, 597, 742, 576, 659, 599, 278, 278, 278, 1033, 987, 742, 670, 706, 575, 710, 646, 648, 648, 576, 738, 597, 1017, 605, 706, 706, 670, 710, 815, 710, 743, 710,
+        569, 659, 577, 575, 813, 647, 733, 647, 1010, 1033, 786, 833, 648, 659, 1019, 656, 452, 454, 454, 403, 517, 418, 712, 424, 494, 494, 469, 497, 570, 497, 520, 497,
+        398, 461, 404, 402, 569, 453, 513, 453, 707, 723, 550, 583, 454, 461, 713, 459, 418, 418, 519, 403, 461, 419, 195, 195, 195, 723, 691, 519, 469, 494, 402, 497,
+        881, 617, 727, 509, 890, 623, 830, 581, 1095, 766, 743, 520, 969, 678, 601, 421, 809, 566, 743, 520, 738, 517, 738, 517, 937, 656, 900, 630, 1114, 780, 881, 617,
+        659, 461, 474, 0, 0, 0, 0, 0, 0, 0, 729, 510, 648, 454, 569, 398, 576, 403, 637, 446, 589, 412, 1017, 712, 605, 424, 670, 469, 670, 469, 670, 469,
+        809, 566, 710, 497, 957, 670, 1021, 715, 829, 580, 659, 461, 577, 404, 577, 404, 577, 404, 647, 453, 882, 617, 647, 453, 647, 453, 647, 453, 888, 622, 888, 622,
+        278, 1017, 712, 619, 433, 733, 513, 710, 497, 733, 513, 647, 453, 838, 587, 195, 646, 452, 646, 452, 920, 644, 597, 418, 743, 520, 743, 520, 1017, 712, 605, 424,
+        629, 440, 706, 494, 706, 494, 743, 520, 743, 520, 743, 520, 659, 461, 575, 402, 575, 402, 575, 402, 647, 453, 576, 403, 833, 583, 637, 446, 647, 453, 647, 453,
+    }, {
+        648, 454, 950, 665, 920, 644, 641, 449, 1012, 708, 1051, 736, 732, 512, 730, 511, 580, 406, 710, 497, 1104, 773, 844, 591, 974, 682, 743, 520, 934, 654, 670, 469,
+        1020, 714, 1021, 715, 749, 524, 489, 342, 489, 342, 489, 342, 489, 342, 489, 342, 489, 723, 691, 711, 711, 691, 729, 604, 691, 811, 711, 652, 503, 870, 815, 691,
+        676, 723, 711, 724, 747, 687, 688, 715, 691, 673, 756, 725, 747, 691, 711, 666, 655, 702, 508, 765, 715, 743, 746, 489, 489, 290, 300, 221, 341, 225, 383, 472,
+        489, 506, 484, 498, 498, 484, 510, 423, 484, 568, 498, 456, 352, 609, 570, 484, 473, 506, 498, 507, 523, 481, 482, 500, 484, 471, 529, 507, 523, 484, 498, 466,
+        458, 491, 356, 536, 500, 520, 522, 766, 489, 318, 341, 489, 489, 489, 489, 489, 489, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 341, 0,
+        278, 0, 0, 278, 0, 0, 417, 0, 489, 489, 489, 489, 489, 489, 489, 489, 631, 546, 389, 515, 617, 257, 327, 617, 612, 211, 507, 499, 537, 626, 641, 257,
+        378, 613, 591, 604, 590, 509, 560, 670, 533, 669, 620, 489, 489, 489, 489, 489, 444, 399, 312, 392, 609, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489,
+    }, {
+        646, 452, 648, 454, 648, 454, 648, 454, 659, 461, 727, 509, 727, 509, 727, 509, 727, 509, 727, 509, 597, 418, 597, 418, 597, 418, 597, 418, 597, 418, 543, 380,
+        732, 512, 710, 497, 710, 497, 710, 497, 710, 497, 710, 497, 278, 195, 278, 195, 619, 433, 619, 433, 619, 433, 526, 368, 526, 368, 526, 368, 526, 368, 815, 570,
+        815, 570, 815, 570, 706, 494, 706, 494, 706, 494, 706, 494, 743, 520, 743, 520, 743, 520, 743, 520, 569, 398, 569, 398, 656, 459, 656, 459, 656, 459, 656, 459,
+        599, 419, 599, 419, 599, 419, 599, 419, 599, 419, 577, 404, 577, 404, 577, 404, 577, 404, 691, 484, 691, 484, 691, 484, 691, 484, 691, 484, 646, 452, 646, 452,
+        934, 654, 934, 654, 934, 654, 934, 654, 934, 654, 647, 453, 647, 453, 577, 404, 647, 453, 647, 453, 647, 453, 598, 370, 772, 559, 579, 419, 332, 332, 726, 578,
+        646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 646, 452, 597, 418, 597, 418, 597, 418, 597, 418,
+        597, 418, 597, 418, 597, 418, 597, 418, 278, 195, 278, 195, 743, 520, 743, 520, 743, 520, 743, 520, 743, 520, 743, 520, 743, 520, 862, 603, 862, 603, 862, 603,
+        862, 603, 862, 603, 691, 484, 691, 484, 810, 567, 810, 567, 810, 567, 810, 567, 810, 567, 577, 404, 577, 404, 577, 404, 577, 404, 726, 508, 489, 342, 489, 342,
+    }, {
+        472, 944, 472, 944, 311, 236, 158, 601, 300, 189, 94, 0, 0, 0, 0, 0, 341, 341, 601, 556, 1000, 944, 472, 472, 222, 222, 222, 300, 333, 333, 333, 489,
+        556, 556, 350, 557, 316, 630, 1000, 300, 0, 0, 0, 0, 0, 0, 0, 189, 1000, 1638, 214, 353, 491, 214, 353, 491, 320, 333, 333, 791, 458, 501, 472, 759,
+        759, 236, 944, 472, 167, 368, 368, 870, 692, 692, 469, 601, 472, 472, 472, 318, 759, 472, 425, 944, 759, 791, 553, 626, 791, 791, 300, 753, 791, 300, 300, 210,
+        0, 0, 0, 0, 0, 489, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 378, 169, 489, 489, 378, 378, 378, 378, 378, 378, 498, 498, 498, 232, 232, 376,
+        378, 378, 378, 378, 378, 378, 378, 378, 378, 378, 498, 498, 498, 232, 232, 489, 370, 394, 390, 419, 394, 382, 402, 157, 588, 376, 404, 352, 278, 489, 489, 489,
+        828, 601, 601, 601, 601, 920, 601, 1201, 1014, 934, 740, 601, 556, 601, 601, 1201, 601, 601, 601, 601, 731, 601, 489, 489, 601, 601, 601, 489, 489, 601, 489, 489,
+        489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489, 489,
+    }, {
+        962, 962, 659, 1060, 606, 962, 1007, 580, 659, 898, 489, 933, 712, 802, 598, 598, 443, 658, 680, 390, 772, 756, 982, 944, 658, 662, 743, 753, 768, 748, 846, 646,
+        963, 1014, 1000, 646, 703, 545, 721, 721, 582, 319, 619, 646, 742, 664, 807, 559, 572, 742, 543, 1010, 436, 703, 636, 440, 609, 359, 874, 1127, 663, 687, 618, 801,
+        765, 732, 526, 526, 577, 773, 668, 581, 331, 331, 489, 736, 489, 489, 380, 489, 915, 915, 1294, 915, 915, 915, 915, 915, 915, 915, 915, 915, 915, 915, 915, 536,
+        278, 465, 651, 871, 646, 871, 1057, 1243, 866, 647, 881, 1068, 526, 659, 727, 815, 262, 432, 602, 766, 559, 766, 935, 1105, 773, 559, 776, 946, 262, 519, 599, 920,
+        1176, 727, 1176, 664, 465, 659, 489, 489, 489, 915, 489, 489, 489, 489, 489, 489, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+        791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+        791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+        791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791, 791,
+    }}}, 474, fontWideAdvance};
+
+// 'font' with every narrow advance scaled by percent / 100, for a font that is drawn like it but
+// runs narrower or wider. Wide clusters stay a whole em.
+inline constexpr FontMetrics scaledFontMetrics(const FontMetrics &font, int percent) {
+    FontMetrics scaled = font;
+    for (auto &page: scaled.advances)
+        for (auto &advance: page) advance = static_cast<uint16_t>((advance * percent + 50) / 100);
+    scaled.fallback = static_cast<uint16_t>((font.fallback * percent + 50) / 100);
+    return scaled;
+}
+
+// Roboto, which YouTube shows by default, has no metrics of its own here. It is drawn much like
+// Arial but runs narrower: its capitals by about 6% and its space by 11%, while its lowercase
+// letters match. Helvetica is scaled by the average over chat text, which is mostly lowercase.
+inline constexpr FontMetrics robotoFontMetrics = scaledFontMetrics(sansFontMetrics, 96);
+
+// Comic Sans runs about an eighth wider than Arial.
+inline constexpr FontMetrics comicSansFontMetrics = scaledFontMetrics(sansFontMetrics, 112);
+
+// Advance of a narrow character that starts a grapheme cluster.
+inline int fontAdvance(const FontMetrics &font, char32_t cp) {
+    const char32_t page = cp / fontPageSize;
+    if (page < fontPageIndex.size() && fontPageIndex[page] >= 0)
+        return font.advances[fontPageIndex[page]][cp % fontPageSize];
+    return font.fallback;
+}
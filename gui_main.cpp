@@ -19,6 +19,7 @@
 
 #include "stb_image.h"
 #include "ytt_generator.h"
+#include "chat_reader.h"
 #include "fonts/lucon.hpp"
 #include <nfd.h>
 
@@ -148,18 +149,16 @@ void ShowDockSpace() {
 }
 
 void ShowColorEdit(const char *label, Color &color) {
-    float col[4] = {color.r / 255.f,
-                    color.g / 255.f,
-                    color.b / 255.f,
-                    color.a / 255.f
+    float col[4] = {color.r() / 255.f,
+                    color.g() / 255.f,
+                    color.b() / 255.f,
+                    color.a() / 255.f
     };
 
     // ImGui color edit widget
     if (ImGui::ColorEdit4(label, col)) {
-        color.r = col[0] * 255;
-        color.g = col[1] * 255;
-        color.b = col[2] * 255;
-        color.a = col[3] * 255;
+        color = Color(static_cast<Color::cType>(col[0] * 255), static_cast<Color::cType>(col[1] * 255),
+                      static_cast<Color::cType>(col[2] * 255), static_cast<Color::cType>(col[3] * 255));
     }
 }
 
@@ -257,7 +256,8 @@ int main(int, char **) {
             nfdresult_t result = NFD_OpenDialogU8_With(&outPath, &args);
             if (result == NFD_OKAY) {
                 int multiplier = 1; // TODO: some way to customize time units
-                text_overlay.messages = parseCSV(outPath, multiplier);
+                text_overlay.chatLog = parseCSV(outPath, multiplier);
+                text_overlay.messages = text_overlay.chatLog.messages;
                 text_overlay.revalidatePreview = true;
                 NFD_FreePathU8(outPath);
             } else if (result == NFD_CANCEL) {
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "byte_stream.h"
+#include "utf8.h"
+
+// Events produced by JsonReader.
+enum class JsonEvent {
+    BeginObject,
+    EndObject,
+    BeginArray,
+    EndArray,
+    Key,
+    String,
+    Number,
+    Literal, // true, false or null
+    End,
+    Error
+};
+
+// Pull-based (SAX-style) JSON tokenizer over streamed input or a string already in memory.
+// It never builds a DOM: memory use is the input window plus the nesting stack, whatever the
+// document size. Validation is minimal; the reader is meant for well-formed machine-written files.
+class JsonReader {
+public:
+    explicit JsonReader(InputWindow &input) : input_(&input) {
+    }
+
+    // Reads a complete document held in 'text', e.g. one line of a JSON Lines file.
+    explicit JsonReader(std::string_view text) {
+        reset(text);
+    }
+
+    // Starts over on another in-memory document, keeping the allocated buffers.
+    void reset(std::string_view text) {
+        input_ = nullptr;
+        text_ = text;
+        textPos_ = 0;
+        stack_.clear();
+        expectKey_ = false;
+    }
+
+    // Advances to the next event. For Key, String, Number and Literal, value() holds the text
+    // (strings already unescaped), valid until the next call.
+    JsonEvent next() {
+        while (true) {
+            const std::string_view buf = view();
+            size_t pos = this->pos();
+            while (pos < buf.size() && isSeparator(buf[pos])) {
+                if (buf[pos] == ',') expectKey_ = !stack_.empty() && stack_.back();
+                else if (buf[pos] == ':') expectKey_ = false;
+                ++pos;
+            }
+            setPos(pos);
+            if (pos == buf.size()) {
+                if (!refill()) return JsonEvent::End;
+                continue;
+            }
+
+            const char c = buf[pos];
+            switch (c) {
+                case '{':
+                case '[':
+                    stack_.push_back(c == '{');
+                    expectKey_ = c == '{';
+                    setPos(pos + 1);
+                    return c == '{' ? JsonEvent::BeginObject : JsonEvent::BeginArray;
+                case '}':
+                case ']':
+                    if (!stack_.empty()) stack_.pop_back();
+                    expectKey_ = false;
+                    setPos(pos + 1);
+                    return c == '}' ? JsonEvent::EndObject : JsonEvent::EndArray;
+                case '"': {
+                    size_t end = 0;
+                    if (!lexString(buf, pos, end)) break;
+                    setPos(end);
+                    const bool key = expectKey_;
+                    expectKey_ = false;
+                    return key ? JsonEvent::Key : JsonEvent::String;
+                }
+                default: {
+                    size_t end = pos;
+                    while (end < buf.size() && !isSeparator(buf[end]) && buf[end] != '}' && buf[end] != ']') ++end;
+                    if (end == buf.size() && !eof()) break;
+                    value_ = buf.substr(pos, end - pos);
+                    setPos(end);
+                    return (c == '-' || (c >= '0' && c <= '9')) ? JsonEvent::Number : JsonEvent::Literal;
+                }
+            }
+            // The token runs past the end of the window.
+            if (!refill()) return JsonEvent::Error;
+        }
+    }
+
+    std::string_view value() const {
+        return value_;
+    }
+
+    // Nesting depth after the last event: 1 inside the root object, and so on.
+    size_t depth() const {
+        return stack_.size();
+    }
+
+    // Skips the value that follows a Key event, including any nested objects or arrays.
+    // Strings inside are not unescaped.
+    JsonEvent skipValue() {
+        decode_ = false;
+        const JsonEvent event = next();
+        decode_ = true;
+        return skip(event);
+    }
+
+    // Finishes skipping a value whose first event was already read: if it opened an object
+    // or array, consumes everything up to the matching close. Returns the last event consumed.
+    JsonEvent skip(JsonEvent event) {
+        if (event != JsonEvent::BeginObject && event != JsonEvent::BeginArray) return event;
+        decode_ = false;
+        const size_t target = depth() - 1;
+        while (depth() > target && event != JsonEvent::End && event != JsonEvent::Error) event = next();
+        decode_ = true;
+        return event;
+    }
+
+private:
+    std::string_view view() const {
+        return input_ ? input_->view() : text_;
+    }
+
+    size_t pos() const {
+        return input_ ? input_->pos() : textPos_;
+    }
+
+    void setPos(size_t pos) {
+        if (input_) input_->setPos(pos);
+        else textPos_ = pos;
+    }
+
+    bool refill() {
+        return input_ && input_->refill();
+    }
+
+    bool eof() const {
+        return !input_ || input_->eof();
+    }
+
+    static bool isSeparator(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ':';
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    static uint32_t parseHex4(std::string_view s) {
+        uint32_t v = 0;
+        for (char c: s) {
+            const int h = hexValue(c);
+            if (h < 0) return 0xFFFD;
+            v = v << 4 | h;
+        }
+        return v;
+    }
+
+    // Lexes the string starting at the quote at 'pos'. Returns false if it is not complete yet.
+    bool lexString(std::string_view buf, size_t pos, size_t &end) {
+        const size_t begin = pos + 1;
+        bool escaped = false;
+        size_t p = begin;
+        while (true) {
+            p = buf.find_first_of("\"\\", p);
+            if (p == std::string_view::npos) return false;
+            if (buf[p] == '"') break;
+            escaped = true;
+            p += 2;
+        }
+        end = p + 1;
+        const std::string_view raw = buf.substr(begin, p - begin);
+        if (!escaped || !decode_) {
+            value_ = raw;
+            return true;
+        }
+        scratch_.clear();
+        for (size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '\\' || i + 1 >= raw.size()) {
+                scratch_ += raw[i];
+                continue;
+            }
+            const char e = raw[++i];
+            switch (e) {
+                case 'n': scratch_ += '\n'; break;
+                case 't': scratch_ += '\t'; break;
+                case 'r': scratch_ += '\r'; break;
+                case 'b': scratch_ += '\b'; break;
+                case 'f': scratch_ += '\f'; break;
+                case 'u': {
+                    uint32_t cp = i + 4 < raw.size() ? parseHex4(raw.substr(i + 1, 4)) : 0xFFFD;
+                    i += 4;
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        // High surrogate, combine with the following \uDC00..\uDFFF.
+                        const uint32_t low = i + 6 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u'
+                                                 ? parseHex4(raw.substr(i + 3, 4))
+                                                 : 0;
+                        if (low >= 0xDC00 && low <= 0xDFFF) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            i += 6;
+                        } else {
+                            cp = 0xFFFD;
+                        }
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        cp = 0xFFFD;
+                    }
+                    utf8::append(static_cast<char32_t>(cp), std::back_inserter(scratch_));
+                    break;
+                }
+                default: scratch_ += e; break; // \" \\ \/
+            }
+        }
+        value_ = scratch_;
+        return true;
+    }
+
+    InputWindow *input_ = nullptr;
+    std::string_view text_;
+    size_t textPos_ = 0;
+    std::vector<bool> stack_; // true for objects, false for arrays
+    bool expectKey_ = false;
+    bool decode_ = true;
+    std::string_view value_;
+    std::string scratch_;
+};
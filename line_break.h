@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include "display_width.h"
+#include "unicode_tables.h"
+#include "utf8.h"
+
+// Line break opportunities inside a word, i.e. a run of text without ASCII whitespace, by the rules
+// of UAX #14. Opportunities are only looked for between grapheme clusters, and a cluster has the
+// class of its first code point, which covers LB9 and LB10. The wrapper deals with spaces, so
+// the rules that look across them (LB14 to LB17) are reduced to pairs, and mandatory breaks (BK, NL)
+// are plain opportunities, as newlines are. Text must be valid UTF-8 (see utf8Sanitize).
+
+// What rules LB4 to LB31 say about a pair of adjacent clusters.
+enum class LineBreakPair : uint8_t {
+    Break,
+    Join,
+    JoinUnlessWide, // Before an opening punctuation, unless it is East Asian wide (LB30)
+};
+
+inline constexpr size_t lineBreakCount = static_cast<size_t>(LineBreak::ZWJ) + 1;
+
+// lineBreakPairs[before][after], indexed by LineBreak.
+inline constexpr auto lineBreakPairs = [] {
+    using enum LineBreak;
+    using enum LineBreakPair;
+    auto in = [](LineBreak c, auto... set) { return ((c == set) || ...); };
+    std::array<std::array<LineBreakPair, lineBreakCount>, lineBreakCount> pairs{};
+    for (size_t b = 0; b < lineBreakCount; ++b) {
+        for (size_t a = 0; a < lineBreakCount; ++a) {
+            const auto before = static_cast<LineBreak>(b), after = static_cast<LineBreak>(a);
+            pairs[b][a] = [&] {
+                if (in(before, BK, CR, LF, NL)) return Break; // LB4, LB5
+                if (in(after, BK, CR, LF, NL, SP, ZW)) return Join; // LB6, LB7
+                if (before == ZW) return Break; // LB8
+                if (before == WJ || after == WJ) return Join; // LB11
+                if (before == GL) return Join; // LB12
+                if (after == GL && !in(before, SP, BA, HY)) return Join; // LB12a
+                if (in(after, CL, CP, EX, IS, SY)) return Join; // LB13
+                if (before == OP) return Join; // LB14
+                if (before == QU && after == OP) return Join; // LB15
+                if (in(before, CL, CP) && after == NS) return Join; // LB16
+                if (before == B2 && after == B2) return Join; // LB17
+                if (before == SP) return Break; // LB18
+                if (before == QU || after == QU) return Join; // LB19
+                if (before == CB || after == CB) return Break; // LB20
+                if (in(after, BA, HY, NS) || before == BB) return Join; // LB21
+                if (before == SY && after == HL) return Join; // LB21b
+                if (after == IN) return Join; // LB22
+                if ((in(before, AL, HL) && after == NU) || (before == NU && in(after, AL, HL))) return Join; // LB23
+                if ((before == PR && in(after, ID, EB, EM)) || (in(before, ID, EB, EM) && after == PO))
+                    return Join; // LB23a
+                if ((in(before, PR, PO) && in(after, AL, HL)) || (in(before, AL, HL) && in(after, PR, PO)))
+                    return Join; // LB24
+                if ((in(before, CL, CP, NU) && in(after, PO, PR)) || (in(before, PO, PR) && in(after, OP, NU)) ||
+                    (in(before, HY, IS, NU, SY) && after == NU))
+                    return Join; // LB25
+                if ((before == JL && in(after, JL, JV, H2, H3)) || (in(before, JV, H2) && in(after, JV, JT)) ||
+                    (in(before, JT, H3) && after == JT))
+                    return Join; // LB26
+                if ((in(before, JL, JV, JT, H2, H3) && after == PO) || (before == PR && in(after, JL, JV, JT, H2, H3)))
+                    return Join; // LB27
+                if (in(before, AL, HL) && in(after, AL, HL)) return Join; // LB28
+                if (before == IS && in(after, AL, HL)) return Join; // LB29
+                if (in(before, AL, HL, NU) && after == OP) return JoinUnlessWide; // LB30
+                if (before == CP && in(after, AL, HL, NU)) return Join; // LB30
+                if (before == EB && after == EM) return Join; // LB30b
+                return Break; // LB31; a regional indicator pair is one cluster, so LB30a breaks between pairs
+            }();
+        }
+    }
+    return pairs;
+}();
+
+// asciiLineBreaks[before][after]: whether there is an opportunity between two ASCII characters.
+// The pairs say it all: LB8a, LB21a and LB30 only differ for other characters.
+inline constexpr auto asciiLineBreaks = [] {
+    auto lineBreak = [](char32_t c) {
+        const LineBreak l = lineBreakClass(c);
+        return static_cast<size_t>(l == LineBreak::CM ? LineBreak::AL : l); // Controls are clusters (LB10)
+    };
+    std::array<std::array<bool, 128>, 128> breaks{};
+    for (char32_t b = 0; b < 128; ++b)
+        for (char32_t a = 0; a < 128; ++a) breaks[b][a] = lineBreakPairs[lineBreak(b)][lineBreak(a)] == LineBreakPair::Break;
+    return breaks;
+}();
+
+// Calls onSegment(segment) for the pieces of 'word' between its line break opportunities, in order.
+// 'ascii' tells that every byte of the word is ASCII, as WordScanner::wordEnd finds out.
+template<typename OnSegment>
+void forEachLineSegment(std::string_view word, bool ascii, OnSegment onSegment) {
+    using enum LineBreak;
+    size_t start = 0;
+    // Ends the current piece before word[pos].
+    auto split = [&](size_t pos) {
+        onSegment(word.substr(start, pos - start));
+        start = pos;
+    };
+    if (ascii) {
+        // Every character is a cluster: words hold no CR.
+        for (size_t pos = 1; pos < word.size(); ++pos)
+            if (asciiLineBreaks[static_cast<uint8_t>(word[pos - 1])][static_cast<uint8_t>(word[pos])]) split(pos);
+    } else {
+        LineBreak before = BK; // Nothing joins to the start of the word
+        LineBreak beforeBefore = BK;
+        size_t pos = 0;
+        forEachGrapheme(word, [&](size_t size, int) {
+            auto it = word.begin() + static_cast<std::ptrdiff_t>(pos);
+            const char32_t cp = utf8::unchecked::next(it);
+            LineBreak current = lineBreakClass(cp);
+            if (current == CM || current == ZWJ) current = AL; // LB10
+            bool breaks = false;
+            switch (lineBreakPairs[static_cast<size_t>(before)][static_cast<size_t>(current)]) {
+                case LineBreakPair::Break: breaks = !(beforeBefore == HL && (before == HY || before == BA)); // LB21a
+                    break;
+                case LineBreakPair::Join: break;
+                case LineBreakPair::JoinUnlessWide: breaks = unicodeProperties(cp) & unicodeWide;
+                    break;
+            }
+            // A ZWJ ends the cluster before: never break after it (LB8a).
+            if (breaks && pos >= 3 && word.substr(pos - 3, 3) == "\u200D") breaks = false;
+            if (breaks && pos > start) split(pos);
+            beforeBefore = before;
+            before = current;
+            pos += size;
+            return true;
+        });
+    }
+    if (start < word.size()) onSegment(word.substr(start));
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+#include "display_width.h"
+#include "font_metrics.h"
+#include "utf8.h"
+
+// Measures text for wrapping it into lines of the caption box. Monospaced fonts are measured in
+// display columns (see display_width.h), maxCharsPerLine of them to a line. Proportional fonts add
+// up glyph advances (see font_metrics.h) against a line as wide as maxCharsPerLine characters of
+// Lucida Console, which is how wide the box is drawn. A cluster's advance is that of its first
+// code point, or a whole em if it is two columns wide.
+class LineMetrics {
+public:
+    // Display columns.
+    explicit LineMetrics(int maxChars) : lineWidth_(maxChars) {
+    }
+
+    // Advances of 'font'.
+    LineMetrics(const FontMetrics &font, int maxChars) : font_(&font), lineWidth_(maxChars * lucidaConsoleAdvance) {
+    }
+
+    int lineWidth() const {
+        return lineWidth_;
+    }
+
+    // Width of the space put between two words.
+    int spaceWidth() const {
+        return font_ ? font_->advances[0][' '] : 1;
+    }
+
+    // Width of s, which must be all ASCII without CR, so that each character is a cluster.
+    int asciiWidth(std::string_view s) const {
+        if (!font_) return static_cast<int>(s.size());
+        int width = 0;
+        for (const char c: s) width += font_->advances[0][static_cast<uint8_t>(c)];
+        return width;
+    }
+
+    int width(std::string_view s) const {
+        if (!font_) return displayWidth(s);
+        if (isPlainAscii(s)) return asciiWidth(s);
+        int width = 0;
+        size_t pos = 0;
+        forEachGrapheme(s, [&](size_t size, int columns) {
+            width += clusterWidth(s, pos, columns);
+            pos += size;
+            return true;
+        });
+        return width;
+    }
+
+    // Size in bytes of the longest run of whole clusters at the start of s that is at most 'width'
+    // wide, as displayPrefix. Its width is stored in 'taken'.
+    size_t prefix(std::string_view s, int width, int &taken) const {
+        if (!font_) return displayPrefix(s, width, taken);
+        if (isPlainAscii(s)) return asciiPrefix(s, width, taken);
+        size_t size = 0;
+        taken = 0;
+        forEachGrapheme(s, [&](size_t clusterSize, int columns) {
+            const int clusterAdvance = clusterWidth(s, size, columns);
+            if (taken + clusterAdvance > width) return false;
+            taken += clusterAdvance;
+            size += clusterSize;
+            return true;
+        });
+        return size;
+    }
+
+    // prefix of an s that asciiWidth accepts.
+    size_t asciiPrefix(std::string_view s, int width, int &taken) const {
+        if (!font_) {
+            taken = std::clamp(width, 0, static_cast<int>(s.size()));
+            return static_cast<size_t>(taken);
+        }
+        size_t size = 0;
+        taken = 0;
+        for (; size < s.size(); ++size) {
+            const int advance = font_->advances[0][static_cast<uint8_t>(s[size])];
+            if (taken + advance > width) break;
+            taken += advance;
+        }
+        return size;
+    }
+
+    // The grapheme cluster that starts at s[pos], with its width.
+    Grapheme graphemeAt(std::string_view s, size_t pos) const {
+        Grapheme g = ::graphemeAt(s, pos);
+        if (font_) g.width = clusterWidth(s, pos, g.width);
+        return g;
+    }
+
+private:
+    int clusterWidth(std::string_view s, size_t pos, int columns) const {
+        if (columns == 2) return font_->wide;
+        const auto c = static_cast<uint8_t>(s[pos]);
+        if (c < 0x80) return font_->advances[0][c];
+        auto it = s.begin() + static_cast<std::ptrdiff_t>(pos);
+        return fontAdvance(*font_, utf8::unchecked::next(it));
+    }
+
+    const FontMetrics *font_ = nullptr; // Null for display columns
+    int lineWidth_;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only mapping of a whole file into memory.
+// Views handed out by view() stay valid until the mapping is closed or moved from.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::filesystem::path &path) {
+        open(path);
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(isOpen_, other.isOpen_);
+#if defined(_WIN32)
+            std::swap(mapping_, other.mapping_);
+#endif
+        }
+        return *this;
+    }
+
+    bool open(const std::filesystem::path &path) {
+        close();
+#if defined(_WIN32)
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return false;
+        }
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_ != nullptr) data_ = static_cast<const char *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            if (data_ == nullptr) {
+                if (mapping_ != nullptr) CloseHandle(mapping_);
+                mapping_ = nullptr;
+                CloseHandle(file);
+                size_ = 0;
+                return false;
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void *p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            data_ = static_cast<const char *>(p);
+            // Chat logs are parsed front to back, let the kernel read ahead aggressively.
+            madvise(p, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+#endif
+        isOpen_ = true;
+        return true;
+    }
+
+    void close() {
+#if defined(_WIN32)
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        mapping_ = nullptr;
+#else
+        if (data_ != nullptr) munmap(const_cast<char *>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        isOpen_ = false;
+    }
+
+    bool isOpen() const {
+        return isOpen_;
+    }
+
+    const char *data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    std::string_view view() const {
+        return data_ ? std::string_view(data_, size_) : std::string_view();
+    }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    bool isOpen_ = false;
+#if defined(_WIN32)
+    HANDLE mapping_ = nullptr;
+#endif
+};
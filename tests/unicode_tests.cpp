@@ -0,0 +1,254 @@
+// Checks the text code against the Unicode 14.0.0 conformance tests and the vector UTF-8
+// validator against the scalar one.
+//
+//   unicode_tests grapheme GraphemeBreakTest.txt
+//   unicode_tests line LineBreakTest.txt
+//   unicode_tests utf8
+
+#include "display_width.h"
+#include "line_break.h"
+#include "text_scanner.h"
+#include "utf8_validate.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// One line of a break test: the text and the byte offsets the test expects breaks at,
+// leaving out the start and the end of the text.
+struct BreakCase {
+    std::string text;
+    std::vector<char32_t> codePoints;
+    std::vector<size_t> breaks;
+    std::string line;
+};
+
+// Parses "÷ 0020 × 0308 ÷ # comment". Returns false for lines without a case.
+bool parseBreakCase(const std::string &line, BreakCase &test) {
+    test = BreakCase();
+    test.line = line;
+    const std::string_view body = std::string_view(line).substr(0, line.find('#'));
+    bool breaks = false;
+    size_t pos = 0;
+    while (pos < body.size()) {
+        if (body.substr(pos, 2) == "\xC3\xB7") { // ÷
+            breaks = true;
+            pos += 2;
+        } else if (body.substr(pos, 2) == "\xC3\x97") { // ×
+            breaks = false;
+            pos += 2;
+        } else if (std::isxdigit(static_cast<unsigned char>(body[pos]))) {
+            size_t end = pos;
+            while (end < body.size() && std::isxdigit(static_cast<unsigned char>(body[end]))) ++end;
+            const auto cp = static_cast<char32_t>(std::stoul(std::string(body.substr(pos, end - pos)), nullptr, 16));
+            if (!test.text.empty() && breaks) test.breaks.push_back(test.text.size());
+            test.codePoints.push_back(cp);
+            if (cp < 0xD800 || cp > 0xDFFF) utf8::unchecked::append(cp, std::back_inserter(test.text));
+            pos = end;
+        } else {
+            ++pos;
+        }
+    }
+    return !test.codePoints.empty();
+}
+
+bool hasSurrogate(const BreakCase &test) {
+    for (const char32_t cp: test.codePoints)
+        if (cp >= 0xD800 && cp <= 0xDFFF) return true;
+    return false;
+}
+
+std::vector<size_t> graphemeBreaks(std::string_view text) {
+    std::vector<size_t> breaks;
+    for (size_t pos = graphemeAt(text, 0).size; pos < text.size(); pos += graphemeAt(text, pos).size)
+        breaks.push_back(pos);
+    return breaks;
+}
+
+std::string formatBreaks(const std::vector<size_t> &breaks) {
+    std::string out;
+    for (const size_t pos: breaks) out += std::to_string(pos) + " ";
+    return out;
+}
+
+// Counts the cases that fail and prints the first few of them.
+class Report {
+public:
+    explicit Report(const char *name) : name_(name) {
+    }
+
+    void check(const BreakCase &test, const std::vector<size_t> &found) {
+        ++checked_;
+        if (found == test.breaks) return;
+        if (++failed_ <= 10) {
+            std::cerr << "FAIL: " << test.line << "\n  expected breaks at " << formatBreaks(test.breaks)
+                    << "\n  found breaks at    " << formatBreaks(found) << "\n";
+        }
+    }
+
+    void skip() {
+        ++skipped_;
+    }
+
+    int finish() const {
+        std::cout << name_ << ": " << checked_ - failed_ << " of " << checked_ << " cases passed, " << skipped_
+                << " skipped\n";
+        return checked_ > 0 && failed_ == 0 ? 0 : 1;
+    }
+
+private:
+    const char *name_;
+    size_t checked_ = 0;
+    size_t failed_ = 0;
+    size_t skipped_ = 0;
+};
+
+int testGraphemes(std::ifstream &file) {
+    Report report("GraphemeBreakTest");
+    BreakCase test;
+    for (std::string line; std::getline(file, line);) {
+        if (!parseBreakCase(line, test)) continue;
+        // Lone surrogates cannot be written in UTF-8; chat text never holds them.
+        if (hasSurrogate(test)) {
+            report.skip();
+            continue;
+        }
+        report.check(test, graphemeBreaks(test.text));
+    }
+    return report.finish();
+}
+
+// The wrapper only asks forEachLineSegment about words: text without whitespace, mandatory
+// breaks or spaces, which it breaks at itself. Cases with those are skipped, as are cases that
+// are not about the rules the word code implements:
+// - breaks inside a grapheme cluster: opportunities are only looked for between clusters, so a
+//   cluster is treated as one character where LB9 would only attach combining marks;
+// - numbers next to punctuation: the test file expects the regular expression tailoring of LB25
+//   (example 7 of UAX #14), while the pairs follow the untailored rule.
+bool isLineBreakTested(const BreakCase &test) {
+    using enum LineBreak;
+    if (hasSurrogate(test)) return false;
+    bool number = false, punctuation = false;
+    for (const char32_t cp: test.codePoints) {
+        if (cp < 0x80 && isWordSpace(static_cast<char>(cp))) return false;
+        const LineBreak c = lineBreakClass(cp);
+        if (c == SP || c == BK || c == CR || c == LF || c == NL) return false;
+        if (c == NU) number = true;
+        if (c == PR || c == PO || c == OP || c == CL || c == CP || c == HY || c == IS || c == SY) punctuation = true;
+    }
+    if (number && punctuation) return false;
+    const std::vector<size_t> clusters = graphemeBreaks(test.text);
+    for (const size_t pos: test.breaks)
+        if (!std::ranges::binary_search(clusters, pos)) return false;
+    return true;
+}
+
+int testLineBreaks(std::ifstream &file) {
+    Report report("LineBreakTest");
+    BreakCase test;
+    for (std::string line; std::getline(file, line);) {
+        if (!parseBreakCase(line, test)) continue;
+        if (!isLineBreakTested(test)) {
+            report.skip();
+            continue;
+        }
+        std::vector<size_t> found;
+        size_t pos = 0;
+        forEachLineSegment(test.text, isAscii(test.text), [&](std::string_view segment) {
+            pos += segment.size();
+            if (pos < test.text.size()) found.push_back(pos);
+        });
+        report.check(test, found);
+    }
+    return report.finish();
+}
+
+// Random text made of pieces that are likely to straddle the vector blocks: runs of ASCII, valid
+// sequences, bytes that are invalid at the edges of the allowed ranges and cut-off sequences.
+std::string randomText(std::mt19937 &rng) {
+    static constexpr uint8_t edges[] = {0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0, 0xC1, 0xC2, 0xDF, 0xE0,
+                                        0xED, 0xEE, 0xEF, 0xF0, 0xF3, 0xF4, 0xF5, 0xFF};
+    static constexpr char32_t codePoints[] = {0x7F, 0x80, 0x7FF, 0x800, 0xD7FF, 0xE000, 0xFFFD, 0xFFFF, 0x10000,
+                                              0x10FFFF};
+    std::string text;
+    const size_t pieces = rng() % 24;
+    for (size_t i = 0; i < pieces; ++i) {
+        switch (rng() % 5) {
+            case 0:
+                text.append(rng() % 70, static_cast<char>('a' + rng() % 26));
+                break;
+            case 1: {
+                std::string sequence;
+                utf8::unchecked::append(codePoints[rng() % std::size(codePoints)], std::back_inserter(sequence));
+                text += sequence;
+                break;
+            }
+            case 2:
+                text += static_cast<char>(edges[rng() % std::size(edges)]);
+                break;
+            case 3: {
+                // Surrogates are encoded too, as the invalid sequences they are.
+                std::string sequence;
+                utf8::unchecked::append(0x80 + rng() % 0x10FF80, std::back_inserter(sequence));
+                text += sequence.substr(0, rng() % 2 ? sequence.size() : rng() % sequence.size());
+                break;
+            }
+            default:
+                text += static_cast<char>(rng());
+                break;
+        }
+    }
+    return text;
+}
+
+int testUtf8() {
+    std::mt19937 rng(14);
+    size_t failed = 0;
+    constexpr size_t cases = 1000000;
+    std::string scratch;
+    for (size_t i = 0; i < cases; ++i) {
+        const std::string text = randomText(rng);
+        const bool valid = utf8IsValidScalar(text);
+        bool agrees = utf8IsValid(text) == valid;
+#ifdef SUBCHAT_UTF8_SIMD
+        const int level = utf8SimdLevel();
+        if (level >= 1) agrees = agrees && utf8IsValidSsse3(text) == valid;
+        if (level >= 2) agrees = agrees && utf8IsValidAvx2(text) == valid;
+#endif
+        // A repaired text must be valid, and a valid one must be left alone.
+        const std::string_view repaired = utf8Sanitize(text, scratch);
+        agrees = agrees && utf8IsValidScalar(repaired) && (repaired.data() == text.data()) == valid;
+        if (!agrees && ++failed <= 10) {
+            std::cerr << "FAIL: validators disagree on";
+            for (const char c: text) std::cerr << ' ' << std::hex << static_cast<int>(static_cast<uint8_t>(c)) << std::dec;
+            std::cerr << "\n";
+        }
+    }
+    std::cout << "UTF-8 validator: " << cases - failed << " of " << cases << " random texts agree\n";
+    return failed == 0 ? 0 : 1;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    const std::string_view mode = argc > 1 ? argv[1] : "";
+    if (mode == "utf8") return testUtf8();
+    if ((mode == "grapheme" || mode == "line") && argc > 2) {
+        std::ifstream file(argv[2]);
+        if (!file) {
+            std::cerr << "Error: Cannot open " << argv[2] << "\n";
+            return 1;
+        }
+        return mode == "grapheme" ? testGraphemes(file) : testLineBreaks(file);
+    }
+    std::cerr << "Usage: unicode_tests grapheme <GraphemeBreakTest.txt> | line <LineBreakTest.txt> | utf8\n";
+    return 1;
+}
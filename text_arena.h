@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Append-only storage for text that cannot be viewed in place, e.g. unescaped CSV fields.
+// Text is copied into large blocks, so views stay valid when the arena is moved
+// or spliced into another one.
+class TextArena {
+public:
+    static constexpr size_t blockSize = 64 * 1024;
+
+    TextArena() = default;
+    TextArena(const TextArena &) = delete;
+    TextArena &operator=(const TextArena &) = delete;
+
+    TextArena(TextArena &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    TextArena &operator=(TextArena &&other) noexcept {
+        if (this != &other) {
+            blocks_ = std::move(other.blocks_);
+            used_ = std::exchange(other.used_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            other.blocks_.clear();
+        }
+        return *this;
+    }
+
+    std::string_view store(std::string_view text) {
+        if (text.empty()) return {};
+        if (text.size() > capacity_ - used_) {
+            const size_t size = std::max(blockSize, text.size());
+            blocks_.push_back(std::make_unique_for_overwrite<char[]>(size));
+            used_ = 0;
+            capacity_ = size;
+        }
+        char *dst = blocks_.back().get() + used_;
+        std::memcpy(dst, text.data(), text.size());
+        used_ += text.size();
+        return {dst, text.size()};
+    }
+
+    // Takes over all blocks of 'other'. Views into either arena stay valid.
+    void splice(TextArena &&other) {
+        if (other.blocks_.empty()) return;
+        if (blocks_.empty()) {
+            *this = std::move(other);
+            return;
+        }
+        // Keep our partially filled block last so it continues to be filled.
+        auto last = std::move(blocks_.back());
+        blocks_.pop_back();
+        for (auto &block: other.blocks_) blocks_.push_back(std::move(block));
+        blocks_.push_back(std::move(last));
+        other.blocks_.clear();
+        other.used_ = other.capacity_ = 0;
+    }
+
+    bool empty() const {
+        return blocks_.empty();
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]> > blocks_;
+    size_t used_ = 0;
+    size_t capacity_ = 0;
+};
+
+// Deduplicating store for short strings that must outlive the buffer they were read from,
+// such as usernames in streamed input.
+class StringPool {
+public:
+    std::string_view intern(std::string_view text) {
+        auto it = strings_.find(text);
+        if (it != strings_.end()) return *it;
+        const std::string_view stored = arena_.store(text);
+        strings_.insert(stored);
+        return stored;
+    }
+
+private:
+    TextArena arena_;
+    std::unordered_set<std::string_view> strings_;
+};
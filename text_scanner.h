@@ -0,0 +1,129 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
+
+// Bitmaps of one 32-byte block of (valid) UTF-8 text. Bit i is set when byte i of the block is of that kind.
+struct TextBlockMasks {
+    uint32_t space = 0; // Separates words, see isWordSpace
+    uint32_t high = 0; // Not ASCII
+};
+
+inline constexpr size_t textBlockSize = 32;
+
+// Whitespace that separates words: the bytes std::isspace accepts in the "C" locale.
+inline constexpr bool isWordSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Classifies 32 bytes at once. Uses AVX2 or SSE2 when the compiler targets them, plain loop otherwise.
+inline TextBlockMasks textScanBlock(const char *p) {
+    TextBlockMasks m;
+#if defined(__AVX2__)
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    m.high = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    // '\t'..'\r' are the bytes less than 5 above '\t'.
+    const __m256i control = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+    m.space = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                        _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8(4)), control))));
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    for (int i = 0; i < 2; ++i) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i * 16));
+        const int shift = i * 16;
+        m.high |= static_cast<uint32_t>(_mm_movemask_epi8(v)) << shift;
+        const __m128i control = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+        m.space |= static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                         _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control)))) << shift;
+    }
+#else
+    for (size_t i = 0; i < textBlockSize; ++i) {
+        const uint32_t bit = uint32_t{1} << i;
+        if (isWordSpace(p[i])) m.space |= bit;
+        if (static_cast<uint8_t>(p[i]) >= 0x80) m.high |= bit;
+    }
+#endif
+    return m;
+}
+
+// Masks of the bytes s[pos, pos + 32); bits past the end of s are clear.
+inline TextBlockMasks textScanAt(std::string_view s, size_t pos) {
+    if (pos + textBlockSize <= s.size()) return textScanBlock(s.data() + pos);
+    char tail[textBlockSize] = {};
+    const size_t size = s.size() - pos;
+    std::memcpy(tail, s.data() + pos, size);
+    TextBlockMasks m = textScanBlock(tail);
+    const uint32_t valid = (uint32_t{1} << size) - 1;
+    m.space &= valid;
+    m.high &= valid;
+    return m;
+}
+
+// Whether every byte of s is ASCII.
+inline bool isAscii(std::string_view s) {
+    for (size_t pos = 0; pos < s.size(); pos += textBlockSize)
+        if (textScanAt(s, pos).high != 0) return false;
+    return true;
+}
+
+// Splits text into words for the wrapper. Each 32-byte block is classified once, then words
+// are found from its bitmaps. Positions are expected to move forward.
+class WordScanner {
+public:
+    explicit WordScanner(std::string_view text) : text_(text) {
+    }
+
+    // Start of the first word at or after 'pos', or the size of the text.
+    size_t skipSpaces(size_t pos) {
+        while (pos < text_.size()) {
+            const size_t block = load(pos);
+            const uint32_t words = (~masks_.space & valid_) >> (pos - block);
+            if (words != 0) return pos + std::countr_zero(words);
+            pos = block + textBlockSize;
+        }
+        return text_.size();
+    }
+
+    // End of the word that starts at 'pos'; clears 'ascii' if the word has other characters.
+    size_t wordEnd(size_t pos, bool &ascii) {
+        while (pos < text_.size()) {
+            const size_t block = load(pos);
+            // The end of the text ends the word like a space.
+            const uint32_t ends = (masks_.space | ~valid_) >> (pos - block);
+            const uint32_t high = masks_.high >> (pos - block);
+            if (ends != 0) {
+                const int size = std::countr_zero(ends);
+                if (high & ((uint32_t{1} << size) - 1)) ascii = false;
+                return pos + size;
+            }
+            if (high != 0) ascii = false;
+            pos = block + textBlockSize;
+        }
+        return text_.size();
+    }
+
+private:
+    // Classifies the block holding 'pos' unless it is the current one; returns its start.
+    size_t load(size_t pos) {
+        const size_t block = pos & ~(textBlockSize - 1);
+        if (block != blockStart_) {
+            blockStart_ = block;
+            masks_ = textScanAt(text_, block);
+            const size_t size = text_.size() - block;
+            valid_ = size >= textBlockSize ? ~uint32_t{0} : (uint32_t{1} << size) - 1;
+        }
+        return block;
+    }
+
+    std::string_view text_;
+    size_t blockStart_ = SIZE_MAX;
+    TextBlockMasks masks_;
+    uint32_t valid_ = 0;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "chat_cache.h"
+#include "chat_reader.h"
+
+// Sparse time index of a chat CSV (.sci sidecar), so a clip can be rendered without parsing
+// the whole log. The records are cut into blocks of a fixed number of records; each block
+// remembers its byte range and the smallest and largest timestamp in it. Keeping min/max
+// rather than just the first time keeps the index correct for logs that are not sorted.
+//
+// Layout, native byte order:
+//   SciHeader
+//   TimeIndexBlock blocks[blockCount]
+
+inline constexpr char sciMagic[4] = {'S', 'C', 'I', '1'};
+inline constexpr uint32_t sciVersion = 1;
+
+// Records per block: small enough that a clip reads little beyond its own messages,
+// large enough that the index of a multi-gigabyte log is a few hundred kilobytes.
+inline constexpr uint32_t timeIndexStride = 4096;
+
+struct TimeIndexBlock {
+    uint64_t begin; // Offset of the first record
+    uint64_t end; // Offset just past the last record
+    uint64_t minTime;
+    uint64_t maxTime;
+};
+
+struct SciHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t stride;
+    SccKey key;
+    uint64_t blockCount;
+};
+
+static_assert(sizeof(SciHeader) == 48 && sizeof(TimeIndexBlock) == 32);
+
+// The index file that belongs to 'source': source path with ".sci" appended.
+inline std::filesystem::path sciPathFor(const std::filesystem::path &source) {
+    std::filesystem::path path = source;
+    path += ".sci";
+    return path;
+}
+
+// Scans the records of buf from 'start' on and returns one block per 'stride' records.
+// Only the time column is converted; records without a valid time do not count towards min/max.
+inline std::vector<TimeIndexBlock> buildTimeIndex(std::string_view buf, size_t start, int timeMultiplier,
+                                                  uint32_t stride = timeIndexStride) {
+    std::vector<TimeIndexBlock> blocks;
+    CsvScanner scanner(buf);
+    CsvRecord record;
+    TimeIndexBlock block{start, start, std::numeric_limits<uint64_t>::max(), 0};
+    uint32_t records = 0;
+    size_t pos = start;
+    while (pos < buf.size()) {
+        if (buf[pos] == '\n') {
+            ++pos;
+            continue;
+        }
+        if (buf[pos] == '\r' && pos + 1 < buf.size() && buf[pos + 1] == '\n') {
+            pos += 2;
+            continue;
+        }
+        if (records == stride) {
+            block.end = pos;
+            blocks.push_back(block);
+            block = {pos, pos, std::numeric_limits<uint64_t>::max(), 0};
+            records = 0;
+        }
+        csvParseRecord(scanner, pos, record);
+        ++records;
+        uint64_t time = 0;
+        if (!csvRecordTime(record, timeMultiplier, time)) continue;
+        block.minTime = std::min(block.minTime, time);
+        block.maxTime = std::max(block.maxTime, time);
+    }
+    if (records > 0) {
+        block.end = buf.size();
+        blocks.push_back(block);
+    }
+    return blocks;
+}
+
+// Loads the index at 'path' if it was built from a source matching 'key'.
+inline bool readTimeIndex(const std::filesystem::path &path, const SccKey &key, std::vector<TimeIndexBlock> &blocks) {
+    std::FILE *in = std::fopen(path.string().c_str(), "rb");
+    if (!in) return false;
+    SciHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, in) == 1 &&
+              std::memcmp(header.magic, sciMagic, sizeof(sciMagic)) == 0 && header.version == sciVersion &&
+              header.byteOrder == sccByteOrder && header.key == key && header.blockCount <= key.sourceSize;
+    if (ok) {
+        blocks.resize(header.blockCount);
+        ok = std::fread(blocks.data(), sizeof(TimeIndexBlock), blocks.size(), in) == blocks.size();
+    }
+    std::fclose(in);
+    for (const auto &block: blocks)
+        ok = ok && block.begin <= block.end && block.end <= key.sourceSize;
+    if (!ok) blocks.clear();
+    return ok;
+}
+
+// Writes the index under a temporary name and renames it into place.
+inline bool writeTimeIndex(const std::filesystem::path &path, const SccKey &key,
+                           const std::vector<TimeIndexBlock> &blocks) {
+    std::filesystem::path tmpPath = path;
+    tmpPath += ".tmp";
+    std::FILE *out = std::fopen(tmpPath.string().c_str(), "wb");
+    if (!out) {
+        std::cerr << "Warning: Cannot write time index " << path << "\n";
+        return false;
+    }
+    SciHeader header{};
+    std::memcpy(header.magic, sciMagic, sizeof(sciMagic));
+    header.version = sciVersion;
+    header.byteOrder = sccByteOrder;
+    header.stride = timeIndexStride;
+    header.key = key;
+    header.blockCount = blocks.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              std::fwrite(blocks.data(), sizeof(TimeIndexBlock), blocks.size(), out) == blocks.size();
+    ok = std::fclose(out) == 0 && ok;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmpPath, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(tmpPath, ec);
+        std::cerr << "Warning: Cannot write time index " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Byte ranges of the blocks that may hold messages in [from, to], with adjacent blocks merged.
+inline std::vector<std::pair<size_t, size_t> > timeIndexRanges(const std::vector<TimeIndexBlock> &blocks,
+                                                               uint64_t from, uint64_t to) {
+    std::vector<std::pair<size_t, size_t> > ranges;
+    for (const auto &block: blocks) {
+        if (block.maxTime < from || block.minTime > to) continue;
+        if (!ranges.empty() && ranges.back().second == block.begin) ranges.back().second = block.end;
+        else ranges.emplace_back(block.begin, block.end);
+    }
+    return ranges;
+}
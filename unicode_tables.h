@@ -0,0 +1,673 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+// Character properties needed to lay out chat text in display columns: the Grapheme_Cluster_Break
+// class (UAX #29), Extended_Pictographic (for emoji ZWJ sequences) and whether the East Asian Width
+// is Wide or Fullwidth. Ambiguous characters count as narrow, as in a Western font. Wrapping also
+// needs the Line_Break class (UAX #14), which is kept in tables of its own.
+//
+// The data is Unicode 14.0.0 (GraphemeBreakProperty.txt, emoji-data.txt, EastAsianWidth.txt,
+// LineBreak.txt) as lists of ranges; the lookup tables are built from them at compile time.
+
+// Grapheme_Cluster_Break values, in the low four bits of the properties.
+enum class GraphemeBreak : uint8_t {
+    Other,
+    CR,
+    LF,
+    Control,
+    Extend,
+    ZWJ,
+    RegionalIndicator,
+    Prepend,
+    SpacingMark,
+    L,
+    V,
+    T,
+    LV,
+    LVT,
+};
+
+inline constexpr uint8_t unicodeBreakMask = 0x0F;
+inline constexpr uint8_t unicodePictographic = 0x10; // Extended_Pictographic
+inline constexpr uint8_t unicodeWide = 0x20; // East Asian Width W or F
+
+struct UnicodeRange {
+    char32_t first;
+    char32_t last;
+    uint8_t value; // Properties
+};
+
+// Code points with any property set, in order. Hangul syllables are all listed as LVT;
+// the LV ones (every 28th) are told apart by unicodeProperties.
+inline constexpr UnicodeRange unicodeRanges[] = {
+        {0x00000, 0x00009, 0x03}, {0x0000A, 0x0000A, 0x02}, {0x0000B, 0x0000C, 0x03}, {0x0000D, 0x0000D, 0x01},
+        {0x0000E, 0x0001F, 0x03}, {0x0007F, 0x0009F, 0x03}, {0x000A9, 0x000A9, 0x10}, {0x000AD, 0x000AD, 0x03},
+        {0x000AE, 0x000AE, 0x10}, {0x00300, 0x0036F, 0x04}, {0x00483, 0x00489, 0x04}, {0x00591, 0x005BD, 0x04},
+        {0x005BF, 0x005BF, 0x04}, {0x005C1, 0x005C2, 0x04}, {0x005C4, 0x005C5, 0x04}, {0x005C7, 0x005C7, 0x04},
+        {0x00600, 0x00605, 0x07}, {0x00610, 0x0061A, 0x04}, {0x0061C, 0x0061C, 0x03}, {0x0064B, 0x0065F, 0x04},
+        {0x00670, 0x00670, 0x04}, {0x006D6, 0x006DC, 0x04}, {0x006DD, 0x006DD, 0x07}, {0x006DF, 0x006E4, 0x04},
+        {0x006E7, 0x006E8, 0x04}, {0x006EA, 0x006ED, 0x04}, {0x0070F, 0x0070F, 0x07}, {0x00711, 0x00711, 0x04},
+        {0x00730, 0x0074A, 0x04}, {0x007A6, 0x007B0, 0x04}, {0x007EB, 0x007F3, 0x04}, {0x007FD, 0x007FD, 0x04},
+        {0x00816, 0x00819, 0x04}, {0x0081B, 0x00823, 0x04}, {0x00825, 0x00827, 0x04}, {0x00829, 0x0082D, 0x04},
+        {0x00859, 0x0085B, 0x04}, {0x00890, 0x00891, 0x07}, {0x00898, 0x0089F, 0x04}, {0x008CA, 0x008E1, 0x04},
+        {0x008E2, 0x008E2, 0x07}, {0x008E3, 0x00902, 0x04}, {0x00903, 0x00903, 0x08}, {0x0093A, 0x0093A, 0x04},
+        {0x0093B, 0x0093B, 0x08}, {0x0093C, 0x0093C, 0x04}, {0x0093E, 0x00940, 0x08}, {0x00941, 0x00948, 0x04},
+        {0x00949, 0x0094C, 0x08}, {0x0094D, 0x0094D, 0x04}, {0x0094E, 0x0094F, 0x08}, {0x00951, 0x00957, 0x04},
+        {0x00962, 0x00963, 0x04}, {0x00981, 0x00981, 0x04}, {0x00982, 0x00983, 0x08}, {0x009BC, 0x009BC, 0x04},
+        {0x009BE, 0x009BE, 0x04}, {0x009BF, 0x009C0, 0x08}, {0x009C1, 0x009C4, 0x04}, {0x009C7, 0x009C8, 0x08},
+        {0x009CB, 0x009CC, 0x08}, {0x009CD, 0x009CD, 0x04}, {0x009D7, 0x009D7, 0x04}, {0x009E2, 0x009E3, 0x04},
+        {0x009FE, 0x009FE, 0x04}, {0x00A01, 0x00A02, 0x04}, {0x00A03, 0x00A03, 0x08}, {0x00A3C, 0x00A3C, 0x04},
+        {0x00A3E, 0x00A40, 0x08}, {0x00A41, 0x00A42, 0x04}, {0x00A47, 0x00A48, 0x04}, {0x00A4B, 0x00A4D, 0x04},
+        {0x00A51, 0x00A51, 0x04}, {0x00A70, 0x00A71, 0x04}, {0x00A75, 0x00A75, 0x04}, {0x00A81, 0x00A82, 0x04},
+        {0x00A83, 0x00A83, 0x08}, {0x00ABC, 0x00ABC, 0x04}, {0x00ABE, 0x00AC0, 0x08}, {0x00AC1, 0x00AC5, 0x04},
+        {0x00AC7, 0x00AC8, 0x04}, {0x00AC9, 0x00AC9, 0x08}, {0x00ACB, 0x00ACC, 0x08}, {0x00ACD, 0x00ACD, 0x04},
+        {0x00AE2, 0x00AE3, 0x04}, {0x00AFA, 0x00AFF, 0x04}, {0x00B01, 0x00B01, 0x04}, {0x00B02, 0x00B03, 0x08},
+        {0x00B3C, 0x00B3C, 0x04}, {0x00B3E, 0x00B3F, 0x04}, {0x00B40, 0x00B40, 0x08}, {0x00B41, 0x00B44, 0x04},
+        {0x00B47, 0x00B48, 0x08}, {0x00B4B, 0x00B4C, 0x08}, {0x00B4D, 0x00B4D, 0x04}, {0x00B55, 0x00B57, 0x04},
+        {0x00B62, 0x00B63, 0x04}, {0x00B82, 0x00B82, 0x04}, {0x00BBE, 0x00BBE, 0x04}, {0x00BBF, 0x00BBF, 0x08},
+        {0x00BC0, 0x00BC0, 0x04}, {0x00BC1, 0x00BC2, 0x08}, {0x00BC6, 0x00BC8, 0x08}, {0x00BCA, 0x00BCC, 0x08},
+        {0x00BCD, 0x00BCD, 0x04}, {0x00BD7, 0x00BD7, 0x04}, {0x00C00, 0x00C00, 0x04}, {0x00C01, 0x00C03, 0x08},
+        {0x00C04, 0x00C04, 0x04}, {0x00C3C, 0x00C3C, 0x04}, {0x00C3E, 0x00C40, 0x04}, {0x00C41, 0x00C44, 0x08},
+        {0x00C46, 0x00C48, 0x04}, {0x00C4A, 0x00C4D, 0x04}, {0x00C55, 0x00C56, 0x04}, {0x00C62, 0x00C63, 0x04},
+        {0x00C81, 0x00C81, 0x04}, {0x00C82, 0x00C83, 0x08}, {0x00CBC, 0x00CBC, 0x04}, {0x00CBE, 0x00CBE, 0x08},
+        {0x00CBF, 0x00CBF, 0x04}, {0x00CC0, 0x00CC1, 0x08}, {0x00CC2, 0x00CC2, 0x04}, {0x00CC3, 0x00CC4, 0x08},
+        {0x00CC6, 0x00CC6, 0x04}, {0x00CC7, 0x00CC8, 0x08}, {0x00CCA, 0x00CCB, 0x08}, {0x00CCC, 0x00CCD, 0x04},
+        {0x00CD5, 0x00CD6, 0x04}, {0x00CE2, 0x00CE3, 0x04}, {0x00D00, 0x00D01, 0x04}, {0x00D02, 0x00D03, 0x08},
+        {0x00D3B, 0x00D3C, 0x04}, {0x00D3E, 0x00D3E, 0x04}, {0x00D3F, 0x00D40, 0x08}, {0x00D41, 0x00D44, 0x04},
+        {0x00D46, 0x00D48, 0x08}, {0x00D4A, 0x00D4C, 0x08}, {0x00D4D, 0x00D4D, 0x04}, {0x00D4E, 0x00D4E, 0x07},
+        {0x00D57, 0x00D57, 0x04}, {0x00D62, 0x00D63, 0x04}, {0x00D81, 0x00D81, 0x04}, {0x00D82, 0x00D83, 0x08},
+        {0x00DCA, 0x00DCA, 0x04}, {0x00DCF, 0x00DCF, 0x04}, {0x00DD0, 0x00DD1, 0x08}, {0x00DD2, 0x00DD4, 0x04},
+        {0x00DD6, 0x00DD6, 0x04}, {0x00DD8, 0x00DDE, 0x08}, {0x00DDF, 0x00DDF, 0x04}, {0x00DF2, 0x00DF3, 0x08},
+        {0x00E31, 0x00E31, 0x04}, {0x00E33, 0x00E33, 0x08}, {0x00E34, 0x00E3A, 0x04}, {0x00E47, 0x00E4E, 0x04},
+        {0x00EB1, 0x00EB1, 0x04}, {0x00EB3, 0x00EB3, 0x08}, {0x00EB4, 0x00EBC, 0x04}, {0x00EC8, 0x00ECD, 0x04},
+        {0x00F18, 0x00F19, 0x04}, {0x00F35, 0x00F35, 0x04}, {0x00F37, 0x00F37, 0x04}, {0x00F39, 0x00F39, 0x04},
+        {0x00F3E, 0x00F3F, 0x08}, {0x00F71, 0x00F7E, 0x04}, {0x00F7F, 0x00F7F, 0x08}, {0x00F80, 0x00F84, 0x04},
+        {0x00F86, 0x00F87, 0x04}, {0x00F8D, 0x00F97, 0x04}, {0x00F99, 0x00FBC, 0x04}, {0x00FC6, 0x00FC6, 0x04},
+        {0x0102D, 0x01030, 0x04}, {0x01031, 0x01031, 0x08}, {0x01032, 0x01037, 0x04}, {0x01039, 0x0103A, 0x04},
+        {0x0103B, 0x0103C, 0x08}, {0x0103D, 0x0103E, 0x04}, {0x01056, 0x01057, 0x08}, {0x01058, 0x01059, 0x04},
+        {0x0105E, 0x01060, 0x04}, {0x01071, 0x01074, 0x04}, {0x01082, 0x01082, 0x04}, {0x01084, 0x01084, 0x08},
+        {0x01085, 0x01086, 0x04}, {0x0108D, 0x0108D, 0x04}, {0x0109D, 0x0109D, 0x04}, {0x01100, 0x0115F, 0x29},
+        {0x01160, 0x011A7, 0x0A}, {0x011A8, 0x011FF, 0x0B}, {0x0135D, 0x0135F, 0x04}, {0x01712, 0x01714, 0x04},
+        {0x01715, 0x01715, 0x08}, {0x01732, 0x01733, 0x04}, {0x01734, 0x01734, 0x08}, {0x01752, 0x01753, 0x04},
+        {0x01772, 0x01773, 0x04}, {0x017B4, 0x017B5, 0x04}, {0x017B6, 0x017B6, 0x08}, {0x017B7, 0x017BD, 0x04},
+        {0x017BE, 0x017C5, 0x08}, {0x017C6, 0x017C6, 0x04}, {0x017C7, 0x017C8, 0x08}, {0x017C9, 0x017D3, 0x04},
+        {0x017DD, 0x017DD, 0x04}, {0x0180B, 0x0180D, 0x04}, {0x0180E, 0x0180E, 0x03}, {0x0180F, 0x0180F, 0x04},
+        {0x01885, 0x01886, 0x04}, {0x018A9, 0x018A9, 0x04}, {0x01920, 0x01922, 0x04}, {0x01923, 0x01926, 0x08},
+        {0x01927, 0x01928, 0x04}, {0x01929, 0x0192B, 0x08}, {0x01930, 0x01931, 0x08}, {0x01932, 0x01932, 0x04},
+        {0x01933, 0x01938, 0x08}, {0x01939, 0x0193B, 0x04}, {0x01A17, 0x01A18, 0x04}, {0x01A19, 0x01A1A, 0x08},
+        {0x01A1B, 0x01A1B, 0x04}, {0x01A55, 0x01A55, 0x08}, {0x01A56, 0x01A56, 0x04}, {0x01A57, 0x01A57, 0x08},
+        {0x01A58, 0x01A5E, 0x04}, {0x01A60, 0x01A60, 0x04}, {0x01A62, 0x01A62, 0x04}, {0x01A65, 0x01A6C, 0x04},
+        {0x01A6D, 0x01A72, 0x08}, {0x01A73, 0x01A7C, 0x04}, {0x01A7F, 0x01A7F, 0x04}, {0x01AB0, 0x01ACE, 0x04},
+        {0x01B00, 0x01B03, 0x04}, {0x01B04, 0x01B04, 0x08}, {0x01B34, 0x01B3A, 0x04}, {0x01B3B, 0x01B3B, 0x08},
+        {0x01B3C, 0x01B3C, 0x04}, {0x01B3D, 0x01B41, 0x08}, {0x01B42, 0x01B42, 0x04}, {0x01B43, 0x01B44, 0x08},
+        {0x01B6B, 0x01B73, 0x04}, {0x01B80, 0x01B81, 0x04}, {0x01B82, 0x01B82, 0x08}, {0x01BA1, 0x01BA1, 0x08},
+        {0x01BA2, 0x01BA5, 0x04}, {0x01BA6, 0x01BA7, 0x08}, {0x01BA8, 0x01BA9, 0x04}, {0x01BAA, 0x01BAA, 0x08},
+        {0x01BAB, 0x01BAD, 0x04}, {0x01BE6, 0x01BE6, 0x04}, {0x01BE7, 0x01BE7, 0x08}, {0x01BE8, 0x01BE9, 0x04},
+        {0x01BEA, 0x01BEC, 0x08}, {0x01BED, 0x01BED, 0x04}, {0x01BEE, 0x01BEE, 0x08}, {0x01BEF, 0x01BF1, 0x04},
+        {0x01BF2, 0x01BF3, 0x08}, {0x01C24, 0x01C2B, 0x08}, {0x01C2C, 0x01C33, 0x04}, {0x01C34, 0x01C35, 0x08},
+        {0x01C36, 0x01C37, 0x04}, {0x01CD0, 0x01CD2, 0x04}, {0x01CD4, 0x01CE0, 0x04}, {0x01CE1, 0x01CE1, 0x08},
+        {0x01CE2, 0x01CE8, 0x04}, {0x01CED, 0x01CED, 0x04}, {0x01CF4, 0x01CF4, 0x04}, {0x01CF7, 0x01CF7, 0x08},
+        {0x01CF8, 0x01CF9, 0x04}, {0x01DC0, 0x01DFF, 0x04}, {0x0200B, 0x0200B, 0x03}, {0x0200C, 0x0200C, 0x04},
+        {0x0200D, 0x0200D, 0x05}, {0x0200E, 0x0200F, 0x03}, {0x02028, 0x0202E, 0x03}, {0x0203C, 0x0203C, 0x10},
+        {0x02049, 0x02049, 0x10}, {0x02060, 0x0206F, 0x03}, {0x020D0, 0x020F0, 0x04}, {0x02122, 0x02122, 0x10},
+        {0x02139, 0x02139, 0x10}, {0x02194, 0x02199, 0x10}, {0x021A9, 0x021AA, 0x10}, {0x0231A, 0x0231B, 0x30},
+        {0x02328, 0x02328, 0x10}, {0x02329, 0x0232A, 0x20}, {0x02388, 0x02388, 0x10}, {0x023CF, 0x023CF, 0x10},
+        {0x023E9, 0x023EC, 0x30}, {0x023ED, 0x023EF, 0x10}, {0x023F0, 0x023F0, 0x30}, {0x023F1, 0x023F2, 0x10},
+        {0x023F3, 0x023F3, 0x30}, {0x023F8, 0x023FA, 0x10}, {0x024C2, 0x024C2, 0x10}, {0x025AA, 0x025AB, 0x10},
+        {0x025B6, 0x025B6, 0x10}, {0x025C0, 0x025C0, 0x10}, {0x025FB, 0x025FC, 0x10}, {0x025FD, 0x025FE, 0x30},
+        {0x02600, 0x02605, 0x10}, {0x02607, 0x02612, 0x10}, {0x02614, 0x02615, 0x30}, {0x02616, 0x02647, 0x10},
+        {0x02648, 0x02653, 0x30}, {0x02654, 0x0267E, 0x10}, {0x0267F, 0x0267F, 0x30}, {0x02680, 0x02685, 0x10},
+        {0x02690, 0x02692, 0x10}, {0x02693, 0x02693, 0x30}, {0x02694, 0x026A0, 0x10}, {0x026A1, 0x026A1, 0x30},
+        {0x026A2, 0x026A9, 0x10}, {0x026AA, 0x026AB, 0x30}, {0x026AC, 0x026BC, 0x10}, {0x026BD, 0x026BE, 0x30},
+        {0x026BF, 0x026C3, 0x10}, {0x026C4, 0x026C5, 0x30}, {0x026C6, 0x026CD, 0x10}, {0x026CE, 0x026CE, 0x30},
+        {0x026CF, 0x026D3, 0x10}, {0x026D4, 0x026D4, 0x30}, {0x026D5, 0x026E9, 0x10}, {0x026EA, 0x026EA, 0x30},
+        {0x026EB, 0x026F1, 0x10}, {0x026F2, 0x026F3, 0x30}, {0x026F4, 0x026F4, 0x10}, {0x026F5, 0x026F5, 0x30},
+        {0x026F6, 0x026F9, 0x10}, {0x026FA, 0x026FA, 0x30}, {0x026FB, 0x026FC, 0x10}, {0x026FD, 0x026FD, 0x30},
+        {0x026FE, 0x02704, 0x10}, {0x02705, 0x02705, 0x30}, {0x02708, 0x02709, 0x10}, {0x0270A, 0x0270B, 0x30},
+        {0x0270C, 0x02712, 0x10}, {0x02714, 0x02714, 0x10}, {0x02716, 0x02716, 0x10}, {0x0271D, 0x0271D, 0x10},
+        {0x02721, 0x02721, 0x10}, {0x02728, 0x02728, 0x30}, {0x02733, 0x02734, 0x10}, {0x02744, 0x02744, 0x10},
+        {0x02747, 0x02747, 0x10}, {0x0274C, 0x0274C, 0x30}, {0x0274E, 0x0274E, 0x30}, {0x02753, 0x02755, 0x30},
+        {0x02757, 0x02757, 0x30}, {0x02763, 0x02767, 0x10}, {0x02795, 0x02797, 0x30}, {0x027A1, 0x027A1, 0x10},
+        {0x027B0, 0x027B0, 0x30}, {0x027BF, 0x027BF, 0x30}, {0x02934, 0x02935, 0x10}, {0x02B05, 0x02B07, 0x10},
+        {0x02B1B, 0x02B1C, 0x30}, {0x02B50, 0x02B50, 0x30}, {0x02B55, 0x02B55, 0x30}, {0x02CEF, 0x02CF1, 0x04},
+        {0x02D7F, 0x02D7F, 0x04}, {0x02DE0, 0x02DFF, 0x04}, {0x02E80, 0x02E99, 0x20}, {0x02E9B, 0x02EF3, 0x20},
+        {0x02F00, 0x02FD5, 0x20}, {0x02FF0, 0x02FFB, 0x20}, {0x03000, 0x03029, 0x20}, {0x0302A, 0x0302F, 0x24},
+        {0x03030, 0x03030, 0x30}, {0x03031, 0x0303C, 0x20}, {0x0303D, 0x0303D, 0x30}, {0x0303E, 0x0303E, 0x20},
+        {0x03041, 0x03096, 0x20}, {0x03099, 0x0309A, 0x24}, {0x0309B, 0x030FF, 0x20}, {0x03105, 0x0312F, 0x20},
+        {0x03131, 0x0318E, 0x20}, {0x03190, 0x031E3, 0x20}, {0x031F0, 0x0321E, 0x20}, {0x03220, 0x03247, 0x20},
+        {0x03250, 0x03296, 0x20}, {0x03297, 0x03297, 0x30}, {0x03298, 0x03298, 0x20}, {0x03299, 0x03299, 0x30},
+        {0x0329A, 0x04DBF, 0x20}, {0x04E00, 0x0A48C, 0x20}, {0x0A490, 0x0A4C6, 0x20}, {0x0A66F, 0x0A672, 0x04},
+        {0x0A674, 0x0A67D, 0x04}, {0x0A69E, 0x0A69F, 0x04}, {0x0A6F0, 0x0A6F1, 0x04}, {0x0A802, 0x0A802, 0x04},
+        {0x0A806, 0x0A806, 0x04}, {0x0A80B, 0x0A80B, 0x04}, {0x0A823, 0x0A824, 0x08}, {0x0A825, 0x0A826, 0x04},
+        {0x0A827, 0x0A827, 0x08}, {0x0A82C, 0x0A82C, 0x04}, {0x0A880, 0x0A881, 0x08}, {0x0A8B4, 0x0A8C3, 0x08},
+        {0x0A8C4, 0x0A8C5, 0x04}, {0x0A8E0, 0x0A8F1, 0x04}, {0x0A8FF, 0x0A8FF, 0x04}, {0x0A926, 0x0A92D, 0x04},
+        {0x0A947, 0x0A951, 0x04}, {0x0A952, 0x0A953, 0x08}, {0x0A960, 0x0A97C, 0x29}, {0x0A980, 0x0A982, 0x04},
+        {0x0A983, 0x0A983, 0x08}, {0x0A9B3, 0x0A9B3, 0x04}, {0x0A9B4, 0x0A9B5, 0x08}, {0x0A9B6, 0x0A9B9, 0x04},
+        {0x0A9BA, 0x0A9BB, 0x08}, {0x0A9BC, 0x0A9BD, 0x04}, {0x0A9BE, 0x0A9C0, 0x08}, {0x0A9E5, 0x0A9E5, 0x04},
+        {0x0AA29, 0x0AA2E, 0x04}, {0x0AA2F, 0x0AA30, 0x08}, {0x0AA31, 0x0AA32, 0x04}, {0x0AA33, 0x0AA34, 0x08},
+        {0x0AA35, 0x0AA36, 0x04}, {0x0AA43, 0x0AA43, 0x04}, {0x0AA4C, 0x0AA4C, 0x04}, {0x0AA4D, 0x0AA4D, 0x08},
+        {0x0AA7C, 0x0AA7C, 0x04}, {0x0AAB0, 0x0AAB0, 0x04}, {0x0AAB2, 0x0AAB4, 0x04}, {0x0AAB7, 0x0AAB8, 0x04},
+        {0x0AABE, 0x0AABF, 0x04}, {0x0AAC1, 0x0AAC1, 0x04}, {0x0AAEB, 0x0AAEB, 0x08}, {0x0AAEC, 0x0AAED, 0x04},
+        {0x0AAEE, 0x0AAEF, 0x08}, {0x0AAF5, 0x0AAF5, 0x08}, {0x0AAF6, 0x0AAF6, 0x04}, {0x0ABE3, 0x0ABE4, 0x08},
+        {0x0ABE5, 0x0ABE5, 0x04}, {0x0ABE6, 0x0ABE7, 0x08}, {0x0ABE8, 0x0ABE8, 0x04}, {0x0ABE9, 0x0ABEA, 0x08},
+        {0x0ABEC, 0x0ABEC, 0x08}, {0x0ABED, 0x0ABED, 0x04}, {0x0AC00, 0x0D7A3, 0x2D}, {0x0D7B0, 0x0D7C6, 0x0A},
+        {0x0D7CB, 0x0D7FB, 0x0B}, {0x0F900, 0x0FAFF, 0x20}, {0x0FB1E, 0x0FB1E, 0x04}, {0x0FE00, 0x0FE0F, 0x04},
+        {0x0FE10, 0x0FE19, 0x20}, {0x0FE20, 0x0FE2F, 0x04}, {0x0FE30, 0x0FE52, 0x20}, {0x0FE54, 0x0FE66, 0x20},
+        {0x0FE68, 0x0FE6B, 0x20}, {0x0FEFF, 0x0FEFF, 0x03}, {0x0FF01, 0x0FF60, 0x20}, {0x0FF9E, 0x0FF9F, 0x04},
+        {0x0FFE0, 0x0FFE6, 0x20}, {0x0FFF0, 0x0FFFB, 0x03}, {0x101FD, 0x101FD, 0x04}, {0x102E0, 0x102E0, 0x04},
+        {0x10376, 0x1037A, 0x04}, {0x10A01, 0x10A03, 0x04}, {0x10A05, 0x10A06, 0x04}, {0x10A0C, 0x10A0F, 0x04},
+        {0x10A38, 0x10A3A, 0x04}, {0x10A3F, 0x10A3F, 0x04}, {0x10AE5, 0x10AE6, 0x04}, {0x10D24, 0x10D27, 0x04},
+        {0x10EAB, 0x10EAC, 0x04}, {0x10F46, 0x10F50, 0x04}, {0x10F82, 0x10F85, 0x04}, {0x11000, 0x11000, 0x08},
+        {0x11001, 0x11001, 0x04}, {0x11002, 0x11002, 0x08}, {0x11038, 0x11046, 0x04}, {0x11070, 0x11070, 0x04},
+        {0x11073, 0x11074, 0x04}, {0x1107F, 0x11081, 0x04}, {0x11082, 0x11082, 0x08}, {0x110B0, 0x110B2, 0x08},
+        {0x110B3, 0x110B6, 0x04}, {0x110B7, 0x110B8, 0x08}, {0x110B9, 0x110BA, 0x04}, {0x110BD, 0x110BD, 0x07},
+        {0x110C2, 0x110C2, 0x04}, {0x110CD, 0x110CD, 0x07}, {0x11100, 0x11102, 0x04}, {0x11127, 0x1112B, 0x04},
+        {0x1112C, 0x1112C, 0x08}, {0x1112D, 0x11134, 0x04}, {0x11145, 0x11146, 0x08}, {0x11173, 0x11173, 0x04},
+        {0x11180, 0x11181, 0x04}, {0x11182, 0x11182, 0x08}, {0x111B3, 0x111B5, 0x08}, {0x111B6, 0x111BE, 0x04},
+        {0x111BF, 0x111C0, 0x08}, {0x111C2, 0x111C3, 0x07}, {0x111C9, 0x111CC, 0x04}, {0x111CE, 0x111CE, 0x08},
+        {0x111CF, 0x111CF, 0x04}, {0x1122C, 0x1122E, 0x08}, {0x1122F, 0x11231, 0x04}, {0x11232, 0x11233, 0x08},
+        {0x11234, 0x11234, 0x04}, {0x11235, 0x11235, 0x08}, {0x11236, 0x11237, 0x04}, {0x1123E, 0x1123E, 0x04},
+        {0x112DF, 0x112DF, 0x04}, {0x112E0, 0x112E2, 0x08}, {0x112E3, 0x112EA, 0x04}, {0x11300, 0x11301, 0x04},
+        {0x11302, 0x11303, 0x08}, {0x1133B, 0x1133C, 0x04}, {0x1133E, 0x1133E, 0x04}, {0x1133F, 0x1133F, 0x08},
+        {0x11340, 0x11340, 0x04}, {0x11341, 0x11344, 0x08}, {0x11347, 0x11348, 0x08}, {0x1134B, 0x1134D, 0x08},
+        {0x11357, 0x11357, 0x04}, {0x11362, 0x11363, 0x08}, {0x11366, 0x1136C, 0x04}, {0x11370, 0x11374, 0x04},
+        {0x11435, 0x11437, 0x08}, {0x11438, 0x1143F, 0x04}, {0x11440, 0x11441, 0x08}, {0x11442, 0x11444, 0x04},
+        {0x11445, 0x11445, 0x08}, {0x11446, 0x11446, 0x04}, {0x1145E, 0x1145E, 0x04}, {0x114B0, 0x114B0, 0x04},
+        {0x114B1, 0x114B2, 0x08}, {0x114B3, 0x114B8, 0x04}, {0x114B9, 0x114B9, 0x08}, {0x114BA, 0x114BA, 0x04},
+        {0x114BB, 0x114BC, 0x08}, {0x114BD, 0x114BD, 0x04}, {0x114BE, 0x114BE, 0x08}, {0x114BF, 0x114C0, 0x04},
+        {0x114C1, 0x114C1, 0x08}, {0x114C2, 0x114C3, 0x04}, {0x115AF, 0x115AF, 0x04}, {0x115B0, 0x115B1, 0x08},
+        {0x115B2, 0x115B5, 0x04}, {0x115B8, 0x115BB, 0x08}, {0x115BC, 0x115BD, 0x04}, {0x115BE, 0x115BE, 0x08},
+        {0x115BF, 0x115C0, 0x04}, {0x115DC, 0x115DD, 0x04}, {0x11630, 0x11632, 0x08}, {0x11633, 0x1163A, 0x04},
+        {0x1163B, 0x1163C, 0x08}, {0x1163D, 0x1163D, 0x04}, {0x1163E, 0x1163E, 0x08}, {0x1163F, 0x11640, 0x04},
+        {0x116AB, 0x116AB, 0x04}, {0x116AC, 0x116AC, 0x08}, {0x116AD, 0x116AD, 0x04}, {0x116AE, 0x116AF, 0x08},
+        {0x116B0, 0x116B5, 0x04}, {0x116B6, 0x116B6, 0x08}, {0x116B7, 0x116B7, 0x04}, {0x1171D, 0x1171F, 0x04},
+        {0x11722, 0x11725, 0x04}, {0x11726, 0x11726, 0x08}, {0x11727, 0x1172B, 0x04}, {0x1182C, 0x1182E, 0x08},
+        {0x1182F, 0x11837, 0x04}, {0x11838, 0x11838, 0x08}, {0x11839, 0x1183A, 0x04}, {0x11930, 0x11930, 0x04},
+        {0x11931, 0x11935, 0x08}, {0x11937, 0x11938, 0x08}, {0x1193B, 0x1193C, 0x04}, {0x1193D, 0x1193D, 0x08},
+        {0x1193E, 0x1193E, 0x04}, {0x1193F, 0x1193F, 0x07}, {0x11940, 0x11940, 0x08}, {0x11941, 0x11941, 0x07},
+        {0x11942, 0x11942, 0x08}, {0x11943, 0x11943, 0x04}, {0x119D1, 0x119D3, 0x08}, {0x119D4, 0x119D7, 0x04},
+        {0x119DA, 0x119DB, 0x04}, {0x119DC, 0x119DF, 0x08}, {0x119E0, 0x119E0, 0x04}, {0x119E4, 0x119E4, 0x08},
+        {0x11A01, 0x11A0A, 0x04}, {0x11A33, 0x11A38, 0x04}, {0x11A39, 0x11A39, 0x08}, {0x11A3A, 0x11A3A, 0x07},
+        {0x11A3B, 0x11A3E, 0x04}, {0x11A47, 0x11A47, 0x04}, {0x11A51, 0x11A56, 0x04}, {0x11A57, 0x11A58, 0x08},
+        {0x11A59, 0x11A5B, 0x04}, {0x11A84, 0x11A89, 0x07}, {0x11A8A, 0x11A96, 0x04}, {0x11A97, 0x11A97, 0x08},
+        {0x11A98, 0x11A99, 0x04}, {0x11C2F, 0x11C2F, 0x08}, {0x11C30, 0x11C36, 0x04}, {0x11C38, 0x11C3D, 0x04},
+        {0x11C3E, 0x11C3E, 0x08}, {0x11C3F, 0x11C3F, 0x04}, {0x11C92, 0x11CA7, 0x04}, {0x11CA9, 0x11CA9, 0x08},
+        {0x11CAA, 0x11CB0, 0x04}, {0x11CB1, 0x11CB1, 0x08}, {0x11CB2, 0x11CB3, 0x04}, {0x11CB4, 0x11CB4, 0x08},
+        {0x11CB5, 0x11CB6, 0x04}, {0x11D31, 0x11D36, 0x04}, {0x11D3A, 0x11D3A, 0x04}, {0x11D3C, 0x11D3D, 0x04},
+        {0x11D3F, 0x11D45, 0x04}, {0x11D46, 0x11D46, 0x07}, {0x11D47, 0x11D47, 0x04}, {0x11D8A, 0x11D8E, 0x08},
+        {0x11D90, 0x11D91, 0x04}, {0x11D93, 0x11D94, 0x08}, {0x11D95, 0x11D95, 0x04}, {0x11D96, 0x11D96, 0x08},
+        {0x11D97, 0x11D97, 0x04}, {0x11EF3, 0x11EF4, 0x04}, {0x11EF5, 0x11EF6, 0x08}, {0x13430, 0x13438, 0x03},
+        {0x16AF0, 0x16AF4, 0x04}, {0x16B30, 0x16B36, 0x04}, {0x16F4F, 0x16F4F, 0x04}, {0x16F51, 0x16F87, 0x08},
+        {0x16F8F, 0x16F92, 0x04}, {0x16FE0, 0x16FE3, 0x20}, {0x16FE4, 0x16FE4, 0x24}, {0x16FF0, 0x16FF1, 0x28},
+        {0x17000, 0x187F7, 0x20}, {0x18800, 0x18CD5, 0x20}, {0x18D00, 0x18D08, 0x20}, {0x1AFF0, 0x1AFF3, 0x20},
+        {0x1AFF5, 0x1AFFB, 0x20}, {0x1AFFD, 0x1AFFE, 0x20}, {0x1B000, 0x1B122, 0x20}, {0x1B150, 0x1B152, 0x20},
+        {0x1B164, 0x1B167, 0x20}, {0x1B170, 0x1B2FB, 0x20}, {0x1BC9D, 0x1BC9E, 0x04}, {0x1BCA0, 0x1BCA3, 0x03},
+        {0x1CF00, 0x1CF2D, 0x04}, {0x1CF30, 0x1CF46, 0x04}, {0x1D165, 0x1D165, 0x04}, {0x1D166, 0x1D166, 0x08},
+        {0x1D167, 0x1D169, 0x04}, {0x1D16D, 0x1D16D, 0x08}, {0x1D16E, 0x1D172, 0x04}, {0x1D173, 0x1D17A, 0x03},
+        {0x1D17B, 0x1D182, 0x04}, {0x1D185, 0x1D18B, 0x04}, {0x1D1AA, 0x1D1AD, 0x04}, {0x1D242, 0x1D244, 0x04},
+        {0x1DA00, 0x1DA36, 0x04}, {0x1DA3B, 0x1DA6C, 0x04}, {0x1DA75, 0x1DA75, 0x04}, {0x1DA84, 0x1DA84, 0x04},
+        {0x1DA9B, 0x1DA9F, 0x04}, {0x1DAA1, 0x1DAAF, 0x04}, {0x1E000, 0x1E006, 0x04}, {0x1E008, 0x1E018, 0x04},
+        {0x1E01B, 0x1E021, 0x04}, {0x1E023, 0x1E024, 0x04}, {0x1E026, 0x1E02A, 0x04}, {0x1E130, 0x1E136, 0x04},
+        {0x1E2AE, 0x1E2AE, 0x04}, {0x1E2EC, 0x1E2EF, 0x04}, {0x1E8D0, 0x1E8D6, 0x04}, {0x1E944, 0x1E94A, 0x04},
+        {0x1F000, 0x1F003, 0x10}, {0x1F004, 0x1F004, 0x30}, {0x1F005, 0x1F0CE, 0x10}, {0x1F0CF, 0x1F0CF, 0x30},
+        {0x1F0D0, 0x1F0FF, 0x10}, {0x1F10D, 0x1F10F, 0x10}, {0x1F12F, 0x1F12F, 0x10}, {0x1F16C, 0x1F171, 0x10},
+        {0x1F17E, 0x1F17F, 0x10}, {0x1F18E, 0x1F18E, 0x30}, {0x1F191, 0x1F19A, 0x30}, {0x1F1AD, 0x1F1E5, 0x10},
+        {0x1F1E6, 0x1F1FF, 0x06}, {0x1F200, 0x1F200, 0x20}, {0x1F201, 0x1F202, 0x30}, {0x1F203, 0x1F20F, 0x10},
+        {0x1F210, 0x1F219, 0x20}, {0x1F21A, 0x1F21A, 0x30}, {0x1F21B, 0x1F22E, 0x20}, {0x1F22F, 0x1F22F, 0x30},
+        {0x1F230, 0x1F231, 0x20}, {0x1F232, 0x1F23A, 0x30}, {0x1F23B, 0x1F23B, 0x20}, {0x1F23C, 0x1F23F, 0x10},
+        {0x1F240, 0x1F248, 0x20}, {0x1F249, 0x1F24F, 0x10}, {0x1F250, 0x1F251, 0x30}, {0x1F252, 0x1F25F, 0x10},
+        {0x1F260, 0x1F265, 0x30}, {0x1F266, 0x1F2FF, 0x10}, {0x1F300, 0x1F320, 0x30}, {0x1F321, 0x1F32C, 0x10},
+        {0x1F32D, 0x1F335, 0x30}, {0x1F336, 0x1F336, 0x10}, {0x1F337, 0x1F37C, 0x30}, {0x1F37D, 0x1F37D, 0x10},
+        {0x1F37E, 0x1F393, 0x30}, {0x1F394, 0x1F39F, 0x10}, {0x1F3A0, 0x1F3CA, 0x30}, {0x1F3CB, 0x1F3CE, 0x10},
+        {0x1F3CF, 0x1F3D3, 0x30}, {0x1F3D4, 0x1F3DF, 0x10}, {0x1F3E0, 0x1F3F0, 0x30}, {0x1F3F1, 0x1F3F3, 0x10},
+        {0x1F3F4, 0x1F3F4, 0x30}, {0x1F3F5, 0x1F3F7, 0x10}, {0x1F3F8, 0x1F3FA, 0x30}, {0x1F3FB, 0x1F3FF, 0x24},
+        {0x1F400, 0x1F43E, 0x30}, {0x1F43F, 0x1F43F, 0x10}, {0x1F440, 0x1F440, 0x30}, {0x1F441, 0x1F441, 0x10},
+        {0x1F442, 0x1F4FC, 0x30}, {0x1F4FD, 0x1F4FE, 0x10}, {0x1F4FF, 0x1F53D, 0x30}, {0x1F546, 0x1F54A, 0x10},
+        {0x1F54B, 0x1F54E, 0x30}, {0x1F54F, 0x1F54F, 0x10}, {0x1F550, 0x1F567, 0x30}, {0x1F568, 0x1F579, 0x10},
+        {0x1F57A, 0x1F57A, 0x30}, {0x1F57B, 0x1F594, 0x10}, {0x1F595, 0x1F596, 0x30}, {0x1F597, 0x1F5A3, 0x10},
+        {0x1F5A4, 0x1F5A4, 0x30}, {0x1F5A5, 0x1F5FA, 0x10}, {0x1F5FB, 0x1F64F, 0x30}, {0x1F680, 0x1F6C5, 0x30},
+        {0x1F6C6, 0x1F6CB, 0x10}, {0x1F6CC, 0x1F6CC, 0x30}, {0x1F6CD, 0x1F6CF, 0x10}, {0x1F6D0, 0x1F6D2, 0x30},
+        {0x1F6D3, 0x1F6D4, 0x10}, {0x1F6D5, 0x1F6D7, 0x30}, {0x1F6D8, 0x1F6DC, 0x10}, {0x1F6DD, 0x1F6DF, 0x30},
+        {0x1F6E0, 0x1F6EA, 0x10}, {0x1F6EB, 0x1F6EC, 0x30}, {0x1F6ED, 0x1F6F3, 0x10}, {0x1F6F4, 0x1F6FC, 0x30},
+        {0x1F6FD, 0x1F6FF, 0x10}, {0x1F774, 0x1F77F, 0x10}, {0x1F7D5, 0x1F7DF, 0x10}, {0x1F7E0, 0x1F7EB, 0x30},
+        {0x1F7EC, 0x1F7EF, 0x10}, {0x1F7F0, 0x1F7F0, 0x30}, {0x1F7F1, 0x1F7FF, 0x10}, {0x1F80C, 0x1F80F, 0x10},
+        {0x1F848, 0x1F84F, 0x10}, {0x1F85A, 0x1F85F, 0x10}, {0x1F888, 0x1F88F, 0x10}, {0x1F8AE, 0x1F8FF, 0x10},
+        {0x1F90C, 0x1F93A, 0x30}, {0x1F93C, 0x1F945, 0x30}, {0x1F947, 0x1F9FF, 0x30}, {0x1FA00, 0x1FA6F, 0x10},
+        {0x1FA70, 0x1FA74, 0x30}, {0x1FA75, 0x1FA77, 0x10}, {0x1FA78, 0x1FA7C, 0x30}, {0x1FA7D, 0x1FA7F, 0x10},
+        {0x1FA80, 0x1FA86, 0x30}, {0x1FA87, 0x1FA8F, 0x10}, {0x1FA90, 0x1FAAC, 0x30}, {0x1FAAD, 0x1FAAF, 0x10},
+        {0x1FAB0, 0x1FABA, 0x30}, {0x1FABB, 0x1FABF, 0x10}, {0x1FAC0, 0x1FAC5, 0x30}, {0x1FAC6, 0x1FACF, 0x10},
+        {0x1FAD0, 0x1FAD9, 0x30}, {0x1FADA, 0x1FADF, 0x10}, {0x1FAE0, 0x1FAE7, 0x30}, {0x1FAE8, 0x1FAEF, 0x10},
+        {0x1FAF0, 0x1FAF6, 0x30}, {0x1FAF7, 0x1FAFF, 0x10}, {0x1FC00, 0x1FFFD, 0x10}, {0x20000, 0x2FFFD, 0x20},
+        {0x30000, 0x3FFFD, 0x20}, {0xE0000, 0xE001F, 0x03}, {0xE0020, 0xE007F, 0x04}, {0xE0080, 0xE00FF, 0x03},
+        {0xE0100, 0xE01EF, 0x04}, {0xE01F0, 0xE0FFF, 0x03},
+};
+
+inline constexpr size_t unicodeBlockSize = 256;
+inline constexpr size_t unicodeBlocks = 0x110000 / unicodeBlockSize;
+
+inline constexpr uint8_t unicodeUniformBlock = 0x80;
+
+// Two-level lookup: 'blocks' has one entry per 256 code points. An entry with the top bit set holds
+// the value of the whole block in its low bits; otherwise it is the index of the block in 'mixed'.
+template<size_t Mixed>
+struct UnicodeTables {
+    std::array<uint8_t, unicodeBlocks> blocks{};
+    std::array<std::array<uint8_t, unicodeBlockSize>, Mixed> mixed{};
+
+    // Value of a code point (up to U+10FFFF).
+    constexpr uint8_t operator[](char32_t cp) const {
+        const uint8_t block = blocks[cp / unicodeBlockSize];
+        if (block & unicodeUniformBlock) return static_cast<uint8_t>(block & ~unicodeUniformBlock);
+        return mixed[block][cp % unicodeBlockSize];
+    }
+};
+
+// Calls onBlock(block, range) for every block with the first of 'ranges' that may overlap it.
+template<typename Ranges, typename OnBlock>
+constexpr void forEachUnicodeBlock(const Ranges &ranges, OnBlock onBlock) {
+    size_t range = 0;
+    for (size_t block = 0; block < unicodeBlocks; ++block) {
+        while (range < std::size(ranges) && ranges[range].last < block * unicodeBlockSize) ++range;
+        onBlock(block, range);
+    }
+}
+
+// Value of the block if it is the same for all of its code points. Code points outside the
+// ranges have the value 0.
+template<typename Ranges>
+constexpr std::optional<uint8_t> uniformUnicodeBlock(const Ranges &ranges, size_t block, size_t range) {
+    const char32_t first = static_cast<char32_t>(block * unicodeBlockSize);
+    const char32_t last = static_cast<char32_t>(first + unicodeBlockSize - 1);
+    if (range == std::size(ranges) || ranges[range].first > last) return 0;
+    if (ranges[range].first <= first && ranges[range].last >= last) return static_cast<uint8_t>(ranges[range].value);
+    return std::nullopt;
+}
+
+template<typename Ranges>
+constexpr size_t mixedUnicodeBlocks(const Ranges &ranges) {
+    size_t mixed = 0;
+    forEachUnicodeBlock(ranges, [&](size_t block, size_t range) {
+        if (!uniformUnicodeBlock(ranges, block, range)) ++mixed;
+    });
+    return mixed;
+}
+
+// Builds the lookup tables of 'ranges', which must be in order and have Mixed mixed blocks.
+template<size_t Mixed, typename Ranges>
+constexpr UnicodeTables<Mixed> makeUnicodeTables(const Ranges &ranges) {
+    static_assert(Mixed < unicodeUniformBlock);
+    UnicodeTables<Mixed> tables;
+    size_t mixed = 0;
+    forEachUnicodeBlock(ranges, [&](size_t block, size_t range) {
+        if (const auto uniform = uniformUnicodeBlock(ranges, block, range)) {
+            tables.blocks[block] = unicodeUniformBlock | *uniform;
+            return;
+        }
+        tables.blocks[block] = static_cast<uint8_t>(mixed);
+        auto &entries = tables.mixed[mixed++];
+        for (size_t i = 0; i < unicodeBlockSize; ++i) {
+            const char32_t cp = static_cast<char32_t>(block * unicodeBlockSize + i);
+            while (range < std::size(ranges) && ranges[range].last < cp) ++range;
+            if (range < std::size(ranges) && ranges[range].first <= cp)
+                entries[i] = static_cast<uint8_t>(ranges[range].value);
+        }
+    });
+    return tables;
+}
+
+inline constexpr auto unicodeTables =
+        makeUnicodeTables<mixedUnicodeBlocks(unicodeRanges)>(unicodeRanges);
+
+// Properties of a code point (up to U+10FFFF).
+inline uint8_t unicodeProperties(char32_t cp) {
+    return unicodeTables[cp];
+}
+
+inline GraphemeBreak graphemeBreak(char32_t cp, uint8_t properties) {
+    const auto value = static_cast<GraphemeBreak>(properties & unicodeBreakMask);
+    // Hangul syllables without a final consonant.
+    if (value == GraphemeBreak::LVT && cp >= 0xAC00 && cp <= 0xD7A3 && (cp - 0xAC00) % 28 == 0)
+        return GraphemeBreak::LV;
+    return value;
+}
+
+// Line_Break classes (UAX #14) as the line breaking rules see them: AI, SG and XX are resolved to AL,
+// SA to CM or AL and CJ to NS (rule LB1). Hangul syllables are all listed as H3; the H2 ones are
+// told apart by lineBreakClass, as for grapheme clusters.
+enum class LineBreak : uint8_t {
+    AL, // The default, so it is left out of the ranges
+    BA,
+    BB,
+    B2,
+    BK,
+    CB,
+    CL,
+    CM,
+    CP,
+    CR,
+    EB,
+    EM,
+    EX,
+    GL,
+    HL,
+    HY,
+    ID,
+    IN,
+    IS,
+    JL,
+    JT,
+    JV,
+    H2,
+    H3,
+    LF,
+    NL,
+    NS,
+    NU,
+    OP,
+    PO,
+    PR,
+    QU,
+    RI,
+    SP,
+    SY,
+    WJ,
+    ZW,
+    ZWJ,
+};
+
+struct LineBreakRange {
+    char32_t first;
+    char32_t last;
+    LineBreak value;
+};
+
+// Code points of a class other than AL, in order (LineBreak.txt, with its defaults for unassigned
+// code points).
+inline constexpr auto lineBreakRanges = [] {
+    using enum LineBreak;
+    return std::to_array<LineBreakRange>({
+                {0x00000, 0x00008, CM}, {0x00009, 0x00009, BA}, {0x0000A, 0x0000A, LF}, {0x0000B, 0x0000C, BK},
+                {0x0000D, 0x0000D, CR}, {0x0000E, 0x0001F, CM}, {0x00020, 0x00020, SP}, {0x00021, 0x00021, EX},
+                {0x00022, 0x00022, QU}, {0x00024, 0x00024, PR}, {0x00025, 0x00025, PO}, {0x00027, 0x00027, QU},
+                {0x00028, 0x00028, OP}, {0x00029, 0x00029, CP}, {0x0002B, 0x0002B, PR}, {0x0002C, 0x0002C, IS},
+                {0x0002D, 0x0002D, HY}, {0x0002E, 0x0002E, IS}, {0x0002F, 0x0002F, SY}, {0x00030, 0x00039, NU},
+                {0x0003A, 0x0003B, IS}, {0x0003F, 0x0003F, EX}, {0x0005B, 0x0005B, OP}, {0x0005C, 0x0005C, PR},
+                {0x0005D, 0x0005D, CP}, {0x0007B, 0x0007B, OP}, {0x0007C, 0x0007C, BA}, {0x0007D, 0x0007D, CL},
+                {0x0007F, 0x00084, CM}, {0x00085, 0x00085, NL}, {0x00086, 0x0009F, CM}, {0x000A0, 0x000A0, GL},
+                {0x000A1, 0x000A1, OP}, {0x000A2, 0x000A2, PO}, {0x000A3, 0x000A5, PR}, {0x000AB, 0x000AB, QU},
+                {0x000AD, 0x000AD, BA}, {0x000B0, 0x000B0, PO}, {0x000B1, 0x000B1, PR}, {0x000B4, 0x000B4, BB},
+                {0x000BB, 0x000BB, QU}, {0x000BF, 0x000BF, OP}, {0x002C8, 0x002C8, BB}, {0x002CC, 0x002CC, BB},
+                {0x002DF, 0x002DF, BB}, {0x00300, 0x0034E, CM}, {0x0034F, 0x0034F, GL}, {0x00350, 0x0035B, CM},
+                {0x0035C, 0x00362, GL}, {0x00363, 0x0036F, CM}, {0x0037E, 0x0037E, IS}, {0x00483, 0x00489, CM},
+                {0x00589, 0x00589, IS}, {0x0058A, 0x0058A, BA}, {0x0058F, 0x0058F, PR}, {0x00591, 0x005BD, CM},
+                {0x005BE, 0x005BE, BA}, {0x005BF, 0x005BF, CM}, {0x005C1, 0x005C2, CM}, {0x005C4, 0x005C5, CM},
+                {0x005C6, 0x005C6, EX}, {0x005C7, 0x005C7, CM}, {0x005D0, 0x005EA, HL}, {0x005EF, 0x005F2, HL},
+                {0x00609, 0x0060B, PO}, {0x0060C, 0x0060D, IS}, {0x00610, 0x0061A, CM}, {0x0061B, 0x0061B, EX},
+                {0x0061C, 0x0061C, CM}, {0x0061D, 0x0061F, EX}, {0x0064B, 0x0065F, CM}, {0x00660, 0x00669, NU},
+                {0x0066A, 0x0066A, PO}, {0x0066B, 0x0066C, NU}, {0x00670, 0x00670, CM}, {0x006D4, 0x006D4, EX},
+                {0x006D6, 0x006DC, CM}, {0x006DF, 0x006E4, CM}, {0x006E7, 0x006E8, CM}, {0x006EA, 0x006ED, CM},
+                {0x006F0, 0x006F9, NU}, {0x00711, 0x00711, CM}, {0x00730, 0x0074A, CM}, {0x007A6, 0x007B0, CM},
+                {0x007C0, 0x007C9, NU}, {0x007EB, 0x007F3, CM}, {0x007F8, 0x007F8, IS}, {0x007F9, 0x007F9, EX},
+                {0x007FD, 0x007FD, CM}, {0x007FE, 0x007FF, PR}, {0x00816, 0x00819, CM}, {0x0081B, 0x00823, CM},
+                {0x00825, 0x00827, CM}, {0x00829, 0x0082D, CM}, {0x00859, 0x0085B, CM}, {0x00898, 0x0089F, CM},
+                {0x008CA, 0x008E1, CM}, {0x008E3, 0x00903, CM}, {0x0093A, 0x0093C, CM}, {0x0093E, 0x0094F, CM},
+                {0x00951, 0x00957, CM}, {0x00962, 0x00963, CM}, {0x00964, 0x00965, BA}, {0x00966, 0x0096F, NU},
+                {0x00981, 0x00983, CM}, {0x009BC, 0x009BC, CM}, {0x009BE, 0x009C4, CM}, {0x009C7, 0x009C8, CM},
+                {0x009CB, 0x009CD, CM}, {0x009D7, 0x009D7, CM}, {0x009E2, 0x009E3, CM}, {0x009E6, 0x009EF, NU},
+                {0x009F2, 0x009F3, PO}, {0x009F9, 0x009F9, PO}, {0x009FB, 0x009FB, PR}, {0x009FE, 0x009FE, CM},
+                {0x00A01, 0x00A03, CM}, {0x00A3C, 0x00A3C, CM}, {0x00A3E, 0x00A42, CM}, {0x00A47, 0x00A48, CM},
+                {0x00A4B, 0x00A4D, CM}, {0x00A51, 0x00A51, CM}, {0x00A66, 0x00A6F, NU}, {0x00A70, 0x00A71, CM},
+                {0x00A75, 0x00A75, CM}, {0x00A81, 0x00A83, CM}, {0x00ABC, 0x00ABC, CM}, {0x00ABE, 0x00AC5, CM},
+                {0x00AC7, 0x00AC9, CM}, {0x00ACB, 0x00ACD, CM}, {0x00AE2, 0x00AE3, CM}, {0x00AE6, 0x00AEF, NU},
+                {0x00AF1, 0x00AF1, PR}, {0x00AFA, 0x00AFF, CM}, {0x00B01, 0x00B03, CM}, {0x00B3C, 0x00B3C, CM},
+                {0x00B3E, 0x00B44, CM}, {0x00B47, 0x00B48, CM}, {0x00B4B, 0x00B4D, CM}, {0x00B55, 0x00B57, CM},
+                {0x00B62, 0x00B63, CM}, {0x00B66, 0x00B6F, NU}, {0x00B82, 0x00B82, CM}, {0x00BBE, 0x00BC2, CM},
+                {0x00BC6, 0x00BC8, CM}, {0x00BCA, 0x00BCD, CM}, {0x00BD7, 0x00BD7, CM}, {0x00BE6, 0x00BEF, NU},
+                {0x00BF9, 0x00BF9, PR}, {0x00C00, 0x00C04, CM}, {0x00C3C, 0x00C3C, CM}, {0x00C3E, 0x00C44, CM},
+                {0x00C46, 0x00C48, CM}, {0x00C4A, 0x00C4D, CM}, {0x00C55, 0x00C56, CM}, {0x00C62, 0x00C63, CM},
+                {0x00C66, 0x00C6F, NU}, {0x00C77, 0x00C77, BB}, {0x00C81, 0x00C83, CM}, {0x00C84, 0x00C84, BB},
+                {0x00CBC, 0x00CBC, CM}, {0x00CBE, 0x00CC4, CM}, {0x00CC6, 0x00CC8, CM}, {0x00CCA, 0x00CCD, CM},
+                {0x00CD5, 0x00CD6, CM}, {0x00CE2, 0x00CE3, CM}, {0x00CE6, 0x00CEF, NU}, {0x00D00, 0x00D03, CM},
+                {0x00D3B, 0x00D3C, CM}, {0x00D3E, 0x00D44, CM}, {0x00D46, 0x00D48, CM}, {0x00D4A, 0x00D4D, CM},
+                {0x00D57, 0x00D57, CM}, {0x00D62, 0x00D63, CM}, {0x00D66, 0x00D6F, NU}, {0x00D79, 0x00D79, PO},
+                {0x00D81, 0x00D83, CM}, {0x00DCA, 0x00DCA, CM}, {0x00DCF, 0x00DD4, CM}, {0x00DD6, 0x00DD6, CM},
+                {0x00DD8, 0x00DDF, CM}, {0x00DE6, 0x00DEF, NU}, {0x00DF2, 0x00DF3, CM}, {0x00E31, 0x00E31, CM},
+                {0x00E34, 0x00E3A, CM}, {0x00E3F, 0x00E3F, PR}, {0x00E47, 0x00E4E, CM}, {0x00E50, 0x00E59, NU},
+                {0x00E5A, 0x00E5B, BA}, {0x00EB1, 0x00EB1, CM}, {0x00EB4, 0x00EBC, CM}, {0x00EC8, 0x00ECD, CM},
+                {0x00ED0, 0x00ED9, NU}, {0x00F01, 0x00F04, BB}, {0x00F06, 0x00F07, BB}, {0x00F08, 0x00F08, GL},
+                {0x00F09, 0x00F0A, BB}, {0x00F0B, 0x00F0B, BA}, {0x00F0C, 0x00F0C, GL}, {0x00F0D, 0x00F11, EX},
+                {0x00F12, 0x00F12, GL}, {0x00F14, 0x00F14, EX}, {0x00F18, 0x00F19, CM}, {0x00F20, 0x00F29, NU},
+                {0x00F34, 0x00F34, BA}, {0x00F35, 0x00F35, CM}, {0x00F37, 0x00F37, CM}, {0x00F39, 0x00F39, CM},
+                {0x00F3A, 0x00F3A, OP}, {0x00F3B, 0x00F3B, CL}, {0x00F3C, 0x00F3C, OP}, {0x00F3D, 0x00F3D, CL},
+                {0x00F3E, 0x00F3F, CM}, {0x00F71, 0x00F7E, CM}, {0x00F7F, 0x00F7F, BA}, {0x00F80, 0x00F84, CM},
+                {0x00F85, 0x00F85, BA}, {0x00F86, 0x00F87, CM}, {0x00F8D, 0x00F97, CM}, {0x00F99, 0x00FBC, CM},
+                {0x00FBE, 0x00FBF, BA}, {0x00FC6, 0x00FC6, CM}, {0x00FD0, 0x00FD1, BB}, {0x00FD2, 0x00FD2, BA},
+                {0x00FD3, 0x00FD3, BB}, {0x00FD9, 0x00FDA, GL}, {0x0102B, 0x0103E, CM}, {0x01040, 0x01049, NU},
+                {0x0104A, 0x0104B, BA}, {0x01056, 0x01059, CM}, {0x0105E, 0x01060, CM}, {0x01062, 0x01064, CM},
+                {0x01067, 0x0106D, CM}, {0x01071, 0x01074, CM}, {0x01082, 0x0108D, CM}, {0x0108F, 0x0108F, CM},
+                {0x01090, 0x01099, NU}, {0x0109A, 0x0109D, CM}, {0x01100, 0x0115F, JL}, {0x01160, 0x011A7, JV},
+                {0x011A8, 0x011FF, JT}, {0x0135D, 0x0135F, CM}, {0x01361, 0x01361, BA}, {0x01400, 0x01400, BA},
+                {0x01680, 0x01680, BA}, {0x0169B, 0x0169B, OP}, {0x0169C, 0x0169C, CL}, {0x016EB, 0x016ED, BA},
+                {0x01712, 0x01715, CM}, {0x01732, 0x01734, CM}, {0x01735, 0x01736, BA}, {0x01752, 0x01753, CM},
+                {0x01772, 0x01773, CM}, {0x017B4, 0x017D3, CM}, {0x017D4, 0x017D5, BA}, {0x017D6, 0x017D6, NS},
+                {0x017D8, 0x017D8, BA}, {0x017DA, 0x017DA, BA}, {0x017DB, 0x017DB, PR}, {0x017DD, 0x017DD, CM},
+                {0x017E0, 0x017E9, NU}, {0x01802, 0x01803, EX}, {0x01804, 0x01805, BA}, {0x01806, 0x01806, BB},
+                {0x01808, 0x01809, EX}, {0x0180B, 0x0180D, CM}, {0x0180E, 0x0180E, GL}, {0x0180F, 0x0180F, CM},
+                {0x01810, 0x01819, NU}, {0x01885, 0x01886, CM}, {0x018A9, 0x018A9, CM}, {0x01920, 0x0192B, CM},
+                {0x01930, 0x0193B, CM}, {0x01944, 0x01945, EX}, {0x01946, 0x0194F, NU}, {0x019D0, 0x019D9, NU},
+                {0x01A17, 0x01A1B, CM}, {0x01A55, 0x01A5E, CM}, {0x01A60, 0x01A7C, CM}, {0x01A7F, 0x01A7F, CM},
+                {0x01A80, 0x01A89, NU}, {0x01A90, 0x01A99, NU}, {0x01AB0, 0x01ACE, CM}, {0x01B00, 0x01B04, CM},
+                {0x01B34, 0x01B44, CM}, {0x01B50, 0x01B59, NU}, {0x01B5A, 0x01B5B, BA}, {0x01B5D, 0x01B60, BA},
+                {0x01B6B, 0x01B73, CM}, {0x01B7D, 0x01B7E, BA}, {0x01B80, 0x01B82, CM}, {0x01BA1, 0x01BAD, CM},
+                {0x01BB0, 0x01BB9, NU}, {0x01BE6, 0x01BF3, CM}, {0x01C24, 0x01C37, CM}, {0x01C3B, 0x01C3F, BA},
+                {0x01C40, 0x01C49, NU}, {0x01C50, 0x01C59, NU}, {0x01C7E, 0x01C7F, BA}, {0x01CD0, 0x01CD2, CM},
+                {0x01CD4, 0x01CE8, CM}, {0x01CED, 0x01CED, CM}, {0x01CF4, 0x01CF4, CM}, {0x01CF7, 0x01CF9, CM},
+                {0x01DC0, 0x01DFF, CM}, {0x01FFD, 0x01FFD, BB}, {0x02000, 0x02006, BA}, {0x02007, 0x02007, GL},
+                {0x02008, 0x0200A, BA}, {0x0200B, 0x0200B, ZW}, {0x0200C, 0x0200C, CM}, {0x0200D, 0x0200D, ZWJ},
+                {0x0200E, 0x0200F, CM}, {0x02010, 0x02010, BA}, {0x02011, 0x02011, GL}, {0x02012, 0x02013, BA},
+                {0x02014, 0x02014, B2}, {0x02018, 0x02019, QU}, {0x0201A, 0x0201A, OP}, {0x0201B, 0x0201D, QU},
+                {0x0201E, 0x0201E, OP}, {0x0201F, 0x0201F, QU}, {0x02024, 0x02026, IN}, {0x02027, 0x02027, BA},
+                {0x02028, 0x02029, BK}, {0x0202A, 0x0202E, CM}, {0x0202F, 0x0202F, GL}, {0x02030, 0x02037, PO},
+                {0x02039, 0x0203A, QU}, {0x0203C, 0x0203D, NS}, {0x02044, 0x02044, IS}, {0x02045, 0x02045, OP},
+                {0x02046, 0x02046, CL}, {0x02047, 0x02049, NS}, {0x02056, 0x02056, BA}, {0x02058, 0x0205B, BA},
+                {0x0205D, 0x0205F, BA}, {0x02060, 0x02060, WJ}, {0x02066, 0x0206F, CM}, {0x0207D, 0x0207D, OP},
+                {0x0207E, 0x0207E, CL}, {0x0208D, 0x0208D, OP}, {0x0208E, 0x0208E, CL}, {0x020A0, 0x020A6, PR},
+                {0x020A7, 0x020A7, PO}, {0x020A8, 0x020B5, PR}, {0x020B6, 0x020B6, PO}, {0x020B7, 0x020BA, PR},
+                {0x020BB, 0x020BB, PO}, {0x020BC, 0x020BD, PR}, {0x020BE, 0x020BE, PO}, {0x020BF, 0x020BF, PR},
+                {0x020C0, 0x020C0, PO}, {0x020C1, 0x020CF, PR}, {0x020D0, 0x020F0, CM}, {0x02103, 0x02103, PO},
+                {0x02109, 0x02109, PO}, {0x02116, 0x02116, PR}, {0x02212, 0x02213, PR}, {0x022EF, 0x022EF, IN},
+                {0x02308, 0x02308, OP}, {0x02309, 0x02309, CL}, {0x0230A, 0x0230A, OP}, {0x0230B, 0x0230B, CL},
+                {0x0231A, 0x0231B, ID}, {0x02329, 0x02329, OP}, {0x0232A, 0x0232A, CL}, {0x023F0, 0x023F3, ID},
+                {0x02600, 0x02603, ID}, {0x02614, 0x02615, ID}, {0x02618, 0x02618, ID}, {0x0261A, 0x0261C, ID},
+                {0x0261D, 0x0261D, EB}, {0x0261E, 0x0261F, ID}, {0x02639, 0x0263B, ID}, {0x02668, 0x02668, ID},
+                {0x0267F, 0x0267F, ID}, {0x026BD, 0x026C8, ID}, {0x026CD, 0x026CD, ID}, {0x026CF, 0x026D1, ID},
+                {0x026D3, 0x026D4, ID}, {0x026D8, 0x026D9, ID}, {0x026DC, 0x026DC, ID}, {0x026DF, 0x026E1, ID},
+                {0x026EA, 0x026EA, ID}, {0x026F1, 0x026F5, ID}, {0x026F7, 0x026F8, ID}, {0x026F9, 0x026F9, EB},
+                {0x026FA, 0x026FA, ID}, {0x026FD, 0x02704, ID}, {0x02708, 0x02709, ID}, {0x0270A, 0x0270D, EB},
+                {0x0275B, 0x02760, QU}, {0x02762, 0x02763, EX}, {0x02764, 0x02764, ID}, {0x02768, 0x02768, OP},
+                {0x02769, 0x02769, CL}, {0x0276A, 0x0276A, OP}, {0x0276B, 0x0276B, CL}, {0x0276C, 0x0276C, OP},
+                {0x0276D, 0x0276D, CL}, {0x0276E, 0x0276E, OP}, {0x0276F, 0x0276F, CL}, {0x02770, 0x02770, OP},
+                {0x02771, 0x02771, CL}, {0x02772, 0x02772, OP}, {0x02773, 0x02773, CL}, {0x02774, 0x02774, OP},
+                {0x02775, 0x02775, CL}, {0x027C5, 0x027C5, OP}, {0x027C6, 0x027C6, CL}, {0x027E6, 0x027E6, OP},
+                {0x027E7, 0x027E7, CL}, {0x027E8, 0x027E8, OP}, {0x027E9, 0x027E9, CL}, {0x027EA, 0x027EA, OP},
+                {0x027EB, 0x027EB, CL}, {0x027EC, 0x027EC, OP}, {0x027ED, 0x027ED, CL}, {0x027EE, 0x027EE, OP},
+                {0x027EF, 0x027EF, CL}, {0x02983, 0x02983, OP}, {0x02984, 0x02984, CL}, {0x02985, 0x02985, OP},
+                {0x02986, 0x02986, CL}, {0x02987, 0x02987, OP}, {0x02988, 0x02988, CL}, {0x02989, 0x02989, OP},
+                {0x0298A, 0x0298A, CL}, {0x0298B, 0x0298B, OP}, {0x0298C, 0x0298C, CL}, {0x0298D, 0x0298D, OP},
+                {0x0298E, 0x0298E, CL}, {0x0298F, 0x0298F, OP}, {0x02990, 0x02990, CL}, {0x02991, 0x02991, OP},
+                {0x02992, 0x02992, CL}, {0x02993, 0x02993, OP}, {0x02994, 0x02994, CL}, {0x02995, 0x02995, OP},
+                {0x02996, 0x02996, CL}, {0x02997, 0x02997, OP}, {0x02998, 0x02998, CL}, {0x029D8, 0x029D8, OP},
+                {0x029D9, 0x029D9, CL}, {0x029DA, 0x029DA, OP}, {0x029DB, 0x029DB, CL}, {0x029FC, 0x029FC, OP},
+                {0x029FD, 0x029FD, CL}, {0x02CEF, 0x02CF1, CM}, {0x02CF9, 0x02CF9, EX}, {0x02CFA, 0x02CFC, BA},
+                {0x02CFE, 0x02CFE, EX}, {0x02CFF, 0x02CFF, BA}, {0x02D70, 0x02D70, BA}, {0x02D7F, 0x02D7F, CM},
+                {0x02DE0, 0x02DFF, CM}, {0x02E00, 0x02E0D, QU}, {0x02E0E, 0x02E15, BA}, {0x02E17, 0x02E17, BA},
+                {0x02E18, 0x02E18, OP}, {0x02E19, 0x02E19, BA}, {0x02E1C, 0x02E1D, QU}, {0x02E20, 0x02E21, QU},
+                {0x02E22, 0x02E22, OP}, {0x02E23, 0x02E23, CL}, {0x02E24, 0x02E24, OP}, {0x02E25, 0x02E25, CL},
+                {0x02E26, 0x02E26, OP}, {0x02E27, 0x02E27, CL}, {0x02E28, 0x02E28, OP}, {0x02E29, 0x02E29, CL},
+                {0x02E2A, 0x02E2D, BA}, {0x02E2E, 0x02E2E, EX}, {0x02E30, 0x02E31, BA}, {0x02E33, 0x02E34, BA},
+                {0x02E3A, 0x02E3B, B2}, {0x02E3C, 0x02E3E, BA}, {0x02E40, 0x02E41, BA}, {0x02E42, 0x02E42, OP},
+                {0x02E43, 0x02E4A, BA}, {0x02E4C, 0x02E4C, BA}, {0x02E4E, 0x02E4F, BA}, {0x02E53, 0x02E54, EX},
+                {0x02E55, 0x02E55, OP}, {0x02E56, 0x02E56, CL}, {0x02E57, 0x02E57, OP}, {0x02E58, 0x02E58, CL},
+                {0x02E59, 0x02E59, OP}, {0x02E5A, 0x02E5A, CL}, {0x02E5B, 0x02E5B, OP}, {0x02E5C, 0x02E5C, CL},
+                {0x02E5D, 0x02E5D, BA}, {0x02E80, 0x02E99, ID}, {0x02E9B, 0x02EF3, ID}, {0x02F00, 0x02FD5, ID},
+                {0x02FF0, 0x02FFB, ID}, {0x03000, 0x03000, BA}, {0x03001, 0x03002, CL}, {0x03003, 0x03004, ID},
+                {0x03005, 0x03005, NS}, {0x03006, 0x03007, ID}, {0x03008, 0x03008, OP}, {0x03009, 0x03009, CL},
+                {0x0300A, 0x0300A, OP}, {0x0300B, 0x0300B, CL}, {0x0300C, 0x0300C, OP}, {0x0300D, 0x0300D, CL},
+                {0x0300E, 0x0300E, OP}, {0x0300F, 0x0300F, CL}, {0x03010, 0x03010, OP}, {0x03011, 0x03011, CL},
+                {0x03012, 0x03013, ID}, {0x03014, 0x03014, OP}, {0x03015, 0x03015, CL}, {0x03016, 0x03016, OP},
+                {0x03017, 0x03017, CL}, {0x03018, 0x03018, OP}, {0x03019, 0x03019, CL}, {0x0301A, 0x0301A, OP},
+                {0x0301B, 0x0301B, CL}, {0x0301C, 0x0301C, NS}, {0x0301D, 0x0301D, OP}, {0x0301E, 0x0301F, CL},
+                {0x03020, 0x03029, ID}, {0x0302A, 0x0302F, CM}, {0x03030, 0x03034, ID}, {0x03035, 0x03035, CM},
+                {0x03036, 0x0303A, ID}, {0x0303B, 0x0303C, NS}, {0x0303D, 0x0303F, ID}, {0x03041, 0x03041, NS},
+                {0x03042, 0x03042, ID}, {0x03043, 0x03043, NS}, {0x03044, 0x03044, ID}, {0x03045, 0x03045, NS},
+                {0x03046, 0x03046, ID}, {0x03047, 0x03047, NS}, {0x03048, 0x03048, ID}, {0x03049, 0x03049, NS},
+                {0x0304A, 0x03062, ID}, {0x03063, 0x03063, NS}, {0x03064, 0x03082, ID}, {0x03083, 0x03083, NS},
+                {0x03084, 0x03084, ID}, {0x03085, 0x03085, NS}, {0x03086, 0x03086, ID}, {0x03087, 0x03087, NS},
+                {0x03088, 0x0308D, ID}, {0x0308E, 0x0308E, NS}, {0x0308F, 0x03094, ID}, {0x03095, 0x03096, NS},
+                {0x03099, 0x0309A, CM}, {0x0309B, 0x0309E, NS}, {0x0309F, 0x0309F, ID}, {0x030A0, 0x030A1, NS},
+                {0x030A2, 0x030A2, ID}, {0x030A3, 0x030A3, NS}, {0x030A4, 0x030A4, ID}, {0x030A5, 0x030A5, NS},
+                {0x030A6, 0x030A6, ID}, {0x030A7, 0x030A7, NS}, {0x030A8, 0x030A8, ID}, {0x030A9, 0x030A9, NS},
+                {0x030AA, 0x030C2, ID}, {0x030C3, 0x030C3, NS}, {0x030C4, 0x030E2, ID}, {0x030E3, 0x030E3, NS},
+                {0x030E4, 0x030E4, ID}, {0x030E5, 0x030E5, NS}, {0x030E6, 0x030E6, ID}, {0x030E7, 0x030E7, NS},
+                {0x030E8, 0x030ED, ID}, {0x030EE, 0x030EE, NS}, {0x030EF, 0x030F4, ID}, {0x030F5, 0x030F6, NS},
+                {0x030F7, 0x030FA, ID}, {0x030FB, 0x030FE, NS}, {0x030FF, 0x030FF, ID}, {0x03105, 0x0312F, ID},
+                {0x03131, 0x0318E, ID}, {0x03190, 0x031E3, ID}, {0x031F0, 0x031FF, NS}, {0x03200, 0x0321E, ID},
+                {0x03220, 0x03247, ID}, {0x03250, 0x04DBF, ID}, {0x04E00, 0x0A014, ID}, {0x0A015, 0x0A015, NS},
+                {0x0A016, 0x0A48C, ID}, {0x0A490, 0x0A4C6, ID}, {0x0A4FE, 0x0A4FF, BA}, {0x0A60D, 0x0A60D, BA},
+                {0x0A60E, 0x0A60E, EX}, {0x0A60F, 0x0A60F, BA}, {0x0A620, 0x0A629, NU}, {0x0A66F, 0x0A672, CM},
+                {0x0A674, 0x0A67D, CM}, {0x0A69E, 0x0A69F, CM}, {0x0A6F0, 0x0A6F1, CM}, {0x0A6F3, 0x0A6F7, BA},
+                {0x0A802, 0x0A802, CM}, {0x0A806, 0x0A806, CM}, {0x0A80B, 0x0A80B, CM}, {0x0A823, 0x0A827, CM},
+                {0x0A82C, 0x0A82C, CM}, {0x0A838, 0x0A838, PO}, {0x0A874, 0x0A875, BB}, {0x0A876, 0x0A877, EX},
+                {0x0A880, 0x0A881, CM}, {0x0A8B4, 0x0A8C5, CM}, {0x0A8CE, 0x0A8CF, BA}, {0x0A8D0, 0x0A8D9, NU},
+                {0x0A8E0, 0x0A8F1, CM}, {0x0A8FC, 0x0A8FC, BB}, {0x0A8FF, 0x0A8FF, CM}, {0x0A900, 0x0A909, NU},
+                {0x0A926, 0x0A92D, CM}, {0x0A92E, 0x0A92F, BA}, {0x0A947, 0x0A953, CM}, {0x0A960, 0x0A97C, JL},
+                {0x0A980, 0x0A983, CM}, {0x0A9B3, 0x0A9C0, CM}, {0x0A9C7, 0x0A9C9, BA}, {0x0A9D0, 0x0A9D9, NU},
+                {0x0A9E5, 0x0A9E5, CM}, {0x0A9F0, 0x0A9F9, NU}, {0x0AA29, 0x0AA36, CM}, {0x0AA43, 0x0AA43, CM},
+                {0x0AA4C, 0x0AA4D, CM}, {0x0AA50, 0x0AA59, NU}, {0x0AA5D, 0x0AA5F, BA}, {0x0AA7B, 0x0AA7D, CM},
+                {0x0AAB0, 0x0AAB0, CM}, {0x0AAB2, 0x0AAB4, CM}, {0x0AAB7, 0x0AAB8, CM}, {0x0AABE, 0x0AABF, CM},
+                {0x0AAC1, 0x0AAC1, CM}, {0x0AAEB, 0x0AAEF, CM}, {0x0AAF0, 0x0AAF1, BA}, {0x0AAF5, 0x0AAF6, CM},
+                {0x0ABE3, 0x0ABEA, CM}, {0x0ABEB, 0x0ABEB, BA}, {0x0ABEC, 0x0ABED, CM}, {0x0ABF0, 0x0ABF9, NU},
+                {0x0AC00, 0x0D7A3, H3}, {0x0D7B0, 0x0D7C6, JV}, {0x0D7CB, 0x0D7FB, JT}, {0x0F900, 0x0FAFF, ID},
+                {0x0FB1D, 0x0FB1D, HL}, {0x0FB1E, 0x0FB1E, CM}, {0x0FB1F, 0x0FB28, HL}, {0x0FB2A, 0x0FB36, HL},
+                {0x0FB38, 0x0FB3C, HL}, {0x0FB3E, 0x0FB3E, HL}, {0x0FB40, 0x0FB41, HL}, {0x0FB43, 0x0FB44, HL},
+                {0x0FB46, 0x0FB4F, HL}, {0x0FD3E, 0x0FD3E, CL}, {0x0FD3F, 0x0FD3F, OP}, {0x0FDFC, 0x0FDFC, PO},
+                {0x0FE00, 0x0FE0F, CM}, {0x0FE10, 0x0FE10, IS}, {0x0FE11, 0x0FE12, CL}, {0x0FE13, 0x0FE14, IS},
+                {0x0FE15, 0x0FE16, EX}, {0x0FE17, 0x0FE17, OP}, {0x0FE18, 0x0FE18, CL}, {0x0FE19, 0x0FE19, IN},
+                {0x0FE20, 0x0FE2F, CM}, {0x0FE30, 0x0FE34, ID}, {0x0FE35, 0x0FE35, OP}, {0x0FE36, 0x0FE36, CL},
+                {0x0FE37, 0x0FE37, OP}, {0x0FE38, 0x0FE38, CL}, {0x0FE39, 0x0FE39, OP}, {0x0FE3A, 0x0FE3A, CL},
+                {0x0FE3B, 0x0FE3B, OP}, {0x0FE3C, 0x0FE3C, CL}, {0x0FE3D, 0x0FE3D, OP}, {0x0FE3E, 0x0FE3E, CL},
+                {0x0FE3F, 0x0FE3F, OP}, {0x0FE40, 0x0FE40, CL}, {0x0FE41, 0x0FE41, OP}, {0x0FE42, 0x0FE42, CL},
+                {0x0FE43, 0x0FE43, OP}, {0x0FE44, 0x0FE44, CL}, {0x0FE45, 0x0FE46, ID}, {0x0FE47, 0x0FE47, OP},
+                {0x0FE48, 0x0FE48, CL}, {0x0FE49, 0x0FE4F, ID}, {0x0FE50, 0x0FE50, CL}, {0x0FE51, 0x0FE51, ID},
+                {0x0FE52, 0x0FE52, CL}, {0x0FE54, 0x0FE55, NS}, {0x0FE56, 0x0FE57, EX}, {0x0FE58, 0x0FE58, ID},
+                {0x0FE59, 0x0FE59, OP}, {0x0FE5A, 0x0FE5A, CL}, {0x0FE5B, 0x0FE5B, OP}, {0x0FE5C, 0x0FE5C, CL},
+                {0x0FE5D, 0x0FE5D, OP}, {0x0FE5E, 0x0FE5E, CL}, {0x0FE5F, 0x0FE66, ID}, {0x0FE68, 0x0FE68, ID},
+                {0x0FE69, 0x0FE69, PR}, {0x0FE6A, 0x0FE6A, PO}, {0x0FE6B, 0x0FE6B, ID}, {0x0FEFF, 0x0FEFF, WJ},
+                {0x0FF01, 0x0FF01, EX}, {0x0FF02, 0x0FF03, ID}, {0x0FF04, 0x0FF04, PR}, {0x0FF05, 0x0FF05, PO},
+                {0x0FF06, 0x0FF07, ID}, {0x0FF08, 0x0FF08, OP}, {0x0FF09, 0x0FF09, CL}, {0x0FF0A, 0x0FF0B, ID},
+                {0x0FF0C, 0x0FF0C, CL}, {0x0FF0D, 0x0FF0D, ID}, {0x0FF0E, 0x0FF0E, CL}, {0x0FF0F, 0x0FF19, ID},
+                {0x0FF1A, 0x0FF1B, NS}, {0x0FF1C, 0x0FF1E, ID}, {0x0FF1F, 0x0FF1F, EX}, {0x0FF20, 0x0FF3A, ID},
+                {0x0FF3B, 0x0FF3B, OP}, {0x0FF3C, 0x0FF3C, ID}, {0x0FF3D, 0x0FF3D, CL}, {0x0FF3E, 0x0FF5A, ID},
+                {0x0FF5B, 0x0FF5B, OP}, {0x0FF5C, 0x0FF5C, ID}, {0x0FF5D, 0x0FF5D, CL}, {0x0FF5E, 0x0FF5E, ID},
+                {0x0FF5F, 0x0FF5F, OP}, {0x0FF60, 0x0FF61, CL}, {0x0FF62, 0x0FF62, OP}, {0x0FF63, 0x0FF64, CL},
+                {0x0FF65, 0x0FF65, NS}, {0x0FF66, 0x0FF66, ID}, {0x0FF67, 0x0FF70, NS}, {0x0FF71, 0x0FF9D, ID},
+                {0x0FF9E, 0x0FF9F, NS}, {0x0FFA0, 0x0FFBE, ID}, {0x0FFC2, 0x0FFC7, ID}, {0x0FFCA, 0x0FFCF, ID},
+                {0x0FFD2, 0x0FFD7, ID}, {0x0FFDA, 0x0FFDC, ID}, {0x0FFE0, 0x0FFE0, PO}, {0x0FFE1, 0x0FFE1, PR},
+                {0x0FFE2, 0x0FFE4, ID}, {0x0FFE5, 0x0FFE6, PR}, {0x0FFF9, 0x0FFFB, CM}, {0x0FFFC, 0x0FFFC, CB},
+                {0x10100, 0x10102, BA}, {0x101FD, 0x101FD, CM}, {0x102E0, 0x102E0, CM}, {0x10376, 0x1037A, CM},
+                {0x1039F, 0x1039F, BA}, {0x103D0, 0x103D0, BA}, {0x104A0, 0x104A9, NU}, {0x10857, 0x10857, BA},
+                {0x1091F, 0x1091F, BA}, {0x10A01, 0x10A03, CM}, {0x10A05, 0x10A06, CM}, {0x10A0C, 0x10A0F, CM},
+                {0x10A38, 0x10A3A, CM}, {0x10A3F, 0x10A3F, CM}, {0x10A50, 0x10A57, BA}, {0x10AE5, 0x10AE6, CM},
+                {0x10AF0, 0x10AF5, BA}, {0x10AF6, 0x10AF6, IN}, {0x10B39, 0x10B3F, BA}, {0x10D24, 0x10D27, CM},
+                {0x10D30, 0x10D39, NU}, {0x10EAB, 0x10EAC, CM}, {0x10EAD, 0x10EAD, BA}, {0x10F46, 0x10F50, CM},
+                {0x10F82, 0x10F85, CM}, {0x11000, 0x11002, CM}, {0x11038, 0x11046, CM}, {0x11047, 0x11048, BA},
+                {0x11066, 0x1106F, NU}, {0x11070, 0x11070, CM}, {0x11073, 0x11074, CM}, {0x1107F, 0x11082, CM},
+                {0x110B0, 0x110BA, CM}, {0x110BE, 0x110C1, BA}, {0x110C2, 0x110C2, CM}, {0x110F0, 0x110F9, NU},
+                {0x11100, 0x11102, CM}, {0x11127, 0x11134, CM}, {0x11136, 0x1113F, NU}, {0x11140, 0x11143, BA},
+                {0x11145, 0x11146, CM}, {0x11173, 0x11173, CM}, {0x11175, 0x11175, BB}, {0x11180, 0x11182, CM},
+                {0x111B3, 0x111C0, CM}, {0x111C5, 0x111C6, BA}, {0x111C8, 0x111C8, BA}, {0x111C9, 0x111CC, CM},
+                {0x111CE, 0x111CF, CM}, {0x111D0, 0x111D9, NU}, {0x111DB, 0x111DB, BB}, {0x111DD, 0x111DF, BA},
+                {0x1122C, 0x11237, CM}, {0x11238, 0x11239, BA}, {0x1123B, 0x1123C, BA}, {0x1123E, 0x1123E, CM},
+                {0x112A9, 0x112A9, BA}, {0x112DF, 0x112EA, CM}, {0x112F0, 0x112F9, NU}, {0x11300, 0x11303, CM},
+                {0x1133B, 0x1133C, CM}, {0x1133E, 0x11344, CM}, {0x11347, 0x11348, CM}, {0x1134B, 0x1134D, CM},
+                {0x11357, 0x11357, CM}, {0x11362, 0x11363, CM}, {0x11366, 0x1136C, CM}, {0x11370, 0x11374, CM},
+                {0x11435, 0x11446, CM}, {0x1144B, 0x1144E, BA}, {0x11450, 0x11459, NU}, {0x1145A, 0x1145B, BA},
+                {0x1145E, 0x1145E, CM}, {0x114B0, 0x114C3, CM}, {0x114D0, 0x114D9, NU}, {0x115AF, 0x115B5, CM},
+                {0x115B8, 0x115C0, CM}, {0x115C1, 0x115C1, BB}, {0x115C2, 0x115C3, BA}, {0x115C4, 0x115C5, EX},
+                {0x115C9, 0x115D7, BA}, {0x115DC, 0x115DD, CM}, {0x11630, 0x11640, CM}, {0x11641, 0x11642, BA},
+                {0x11650, 0x11659, NU}, {0x11660, 0x1166C, BB}, {0x116AB, 0x116B7, CM}, {0x116C0, 0x116C9, NU},
+                {0x1171D, 0x1172B, CM}, {0x11730, 0x11739, NU}, {0x1173C, 0x1173E, BA}, {0x1182C, 0x1183A, CM},
+                {0x118E0, 0x118E9, NU}, {0x11930, 0x11935, CM}, {0x11937, 0x11938, CM}, {0x1193B, 0x1193E, CM},
+                {0x11940, 0x11940, CM}, {0x11942, 0x11943, CM}, {0x11944, 0x11946, BA}, {0x11950, 0x11959, NU},
+                {0x119D1, 0x119D7, CM}, {0x119DA, 0x119E0, CM}, {0x119E2, 0x119E2, BB}, {0x119E4, 0x119E4, CM},
+                {0x11A01, 0x11A0A, CM}, {0x11A33, 0x11A39, CM}, {0x11A3B, 0x11A3E, CM}, {0x11A3F, 0x11A3F, BB},
+                {0x11A41, 0x11A44, BA}, {0x11A45, 0x11A45, BB}, {0x11A47, 0x11A47, CM}, {0x11A51, 0x11A5B, CM},
+                {0x11A8A, 0x11A99, CM}, {0x11A9A, 0x11A9C, BA}, {0x11A9E, 0x11AA0, BB}, {0x11AA1, 0x11AA2, BA},
+                {0x11C2F, 0x11C36, CM}, {0x11C38, 0x11C3F, CM}, {0x11C41, 0x11C45, BA}, {0x11C50, 0x11C59, NU},
+                {0x11C70, 0x11C70, BB}, {0x11C71, 0x11C71, EX}, {0x11C92, 0x11CA7, CM}, {0x11CA9, 0x11CB6, CM},
+                {0x11D31, 0x11D36, CM}, {0x11D3A, 0x11D3A, CM}, {0x11D3C, 0x11D3D, CM}, {0x11D3F, 0x11D45, CM},
+                {0x11D47, 0x11D47, CM}, {0x11D50, 0x11D59, NU}, {0x11D8A, 0x11D8E, CM}, {0x11D90, 0x11D91, CM},
+                {0x11D93, 0x11D97, CM}, {0x11DA0, 0x11DA9, NU}, {0x11EF3, 0x11EF6, CM}, {0x11FDD, 0x11FE0, PO},
+                {0x11FFF, 0x11FFF, BA}, {0x12470, 0x12474, BA}, {0x13258, 0x1325A, OP}, {0x1325B, 0x1325D, CL},
+                {0x13282, 0x13282, CL}, {0x13286, 0x13286, OP}, {0x13287, 0x13287, CL}, {0x13288, 0x13288, OP},
+                {0x13289, 0x13289, CL}, {0x13379, 0x13379, OP}, {0x1337A, 0x1337B, CL}, {0x13430, 0x13436, GL},
+                {0x13437, 0x13437, OP}, {0x13438, 0x13438, CL}, {0x145CE, 0x145CE, OP}, {0x145CF, 0x145CF, CL},
+                {0x16A60, 0x16A69, NU}, {0x16A6E, 0x16A6F, BA}, {0x16AC0, 0x16AC9, NU}, {0x16AF0, 0x16AF4, CM},
+                {0x16AF5, 0x16AF5, BA}, {0x16B30, 0x16B36, CM}, {0x16B37, 0x16B39, BA}, {0x16B44, 0x16B44, BA},
+                {0x16B50, 0x16B59, NU}, {0x16E97, 0x16E98, BA}, {0x16F4F, 0x16F4F, CM}, {0x16F51, 0x16F87, CM},
+                {0x16F8F, 0x16F92, CM}, {0x16FE0, 0x16FE3, NS}, {0x16FE4, 0x16FE4, GL}, {0x16FF0, 0x16FF1, CM},
+                {0x17000, 0x187F7, ID}, {0x18800, 0x18AFF, ID}, {0x18D00, 0x18D08, ID}, {0x1B000, 0x1B122, ID},
+                {0x1B150, 0x1B152, NS}, {0x1B164, 0x1B167, NS}, {0x1B170, 0x1B2FB, ID}, {0x1BC9D, 0x1BC9E, CM},
+                {0x1BC9F, 0x1BC9F, BA}, {0x1BCA0, 0x1BCA3, CM}, {0x1CF00, 0x1CF2D, CM}, {0x1CF30, 0x1CF46, CM},
+                {0x1D165, 0x1D169, CM}, {0x1D16D, 0x1D182, CM}, {0x1D185, 0x1D18B, CM}, {0x1D1AA, 0x1D1AD, CM},
+                {0x1D242, 0x1D244, CM}, {0x1D7CE, 0x1D7FF, NU}, {0x1DA00, 0x1DA36, CM}, {0x1DA3B, 0x1DA6C, CM},
+                {0x1DA75, 0x1DA75, CM}, {0x1DA84, 0x1DA84, CM}, {0x1DA87, 0x1DA8A, BA}, {0x1DA9B, 0x1DA9F, CM},
+                {0x1DAA1, 0x1DAAF, CM}, {0x1E000, 0x1E006, CM}, {0x1E008, 0x1E018, CM}, {0x1E01B, 0x1E021, CM},
+                {0x1E023, 0x1E024, CM}, {0x1E026, 0x1E02A, CM}, {0x1E130, 0x1E136, CM}, {0x1E140, 0x1E149, NU},
+                {0x1E2AE, 0x1E2AE, CM}, {0x1E2EC, 0x1E2EF, CM}, {0x1E2F0, 0x1E2F9, NU}, {0x1E2FF, 0x1E2FF, PR},
+                {0x1E8D0, 0x1E8D6, CM}, {0x1E944, 0x1E94A, CM}, {0x1E950, 0x1E959, NU}, {0x1E95E, 0x1E95F, OP},
+                {0x1ECAC, 0x1ECAC, PO}, {0x1ECB0, 0x1ECB0, PO}, {0x1F000, 0x1F0FF, ID}, {0x1F10D, 0x1F10F, ID},
+                {0x1F16D, 0x1F16F, ID}, {0x1F1AD, 0x1F1E5, ID}, {0x1F1E6, 0x1F1FF, RI}, {0x1F200, 0x1F384, ID},
+                {0x1F385, 0x1F385, EB}, {0x1F386, 0x1F39B, ID}, {0x1F39E, 0x1F3B4, ID}, {0x1F3B7, 0x1F3BB, ID},
+                {0x1F3BD, 0x1F3C1, ID}, {0x1F3C2, 0x1F3C4, EB}, {0x1F3C5, 0x1F3C6, ID}, {0x1F3C7, 0x1F3C7, EB},
+                {0x1F3C8, 0x1F3C9, ID}, {0x1F3CA, 0x1F3CC, EB}, {0x1F3CD, 0x1F3FA, ID}, {0x1F3FB, 0x1F3FF, EM},
+                {0x1F400, 0x1F441, ID}, {0x1F442, 0x1F443, EB}, {0x1F444, 0x1F445, ID}, {0x1F446, 0x1F450, EB},
+                {0x1F451, 0x1F465, ID}, {0x1F466, 0x1F478, EB}, {0x1F479, 0x1F47B, ID}, {0x1F47C, 0x1F47C, EB},
+                {0x1F47D, 0x1F480, ID}, {0x1F481, 0x1F483, EB}, {0x1F484, 0x1F484, ID}, {0x1F485, 0x1F487, EB},
+                {0x1F488, 0x1F48E, ID}, {0x1F48F, 0x1F48F, EB}, {0x1F490, 0x1F490, ID}, {0x1F491, 0x1F491, EB},
+                {0x1F492, 0x1F49F, ID}, {0x1F4A1, 0x1F4A1, ID}, {0x1F4A3, 0x1F4A3, ID}, {0x1F4A5, 0x1F4A9, ID},
+                {0x1F4AA, 0x1F4AA, EB}, {0x1F4AB, 0x1F4AE, ID}, {0x1F4B0, 0x1F4B0, ID}, {0x1F4B3, 0x1F4FF, ID},
+                {0x1F507, 0x1F516, ID}, {0x1F525, 0x1F531, ID}, {0x1F54A, 0x1F573, ID}, {0x1F574, 0x1F575, EB},
+                {0x1F576, 0x1F579, ID}, {0x1F57A, 0x1F57A, EB}, {0x1F57B, 0x1F58F, ID}, {0x1F590, 0x1F590, EB},
+                {0x1F591, 0x1F594, ID}, {0x1F595, 0x1F596, EB}, {0x1F597, 0x1F5D3, ID}, {0x1F5DC, 0x1F5F3, ID},
+                {0x1F5FA, 0x1F644, ID}, {0x1F645, 0x1F647, EB}, {0x1F648, 0x1F64A, ID}, {0x1F64B, 0x1F64F, EB},
+                {0x1F676, 0x1F678, QU}, {0x1F679, 0x1F67B, NS}, {0x1F680, 0x1F6A2, ID}, {0x1F6A3, 0x1F6A3, EB},
+                {0x1F6A4, 0x1F6B3, ID}, {0x1F6B4, 0x1F6B6, EB}, {0x1F6B7, 0x1F6BF, ID}, {0x1F6C0, 0x1F6C0, EB},
+                {0x1F6C1, 0x1F6CB, ID}, {0x1F6CC, 0x1F6CC, EB}, {0x1F6CD, 0x1F6FF, ID}, {0x1F774, 0x1F77F, ID},
+                {0x1F7D5, 0x1F7FF, ID}, {0x1F80C, 0x1F80F, ID}, {0x1F848, 0x1F84F, ID}, {0x1F85A, 0x1F85F, ID},
+                {0x1F888, 0x1F88F, ID}, {0x1F8AE, 0x1F8FF, ID}, {0x1F90C, 0x1F90C, EB}, {0x1F90D, 0x1F90E, ID},
+                {0x1F90F, 0x1F90F, EB}, {0x1F910, 0x1F917, ID}, {0x1F918, 0x1F91F, EB}, {0x1F920, 0x1F925, ID},
+                {0x1F926, 0x1F926, EB}, {0x1F927, 0x1F92F, ID}, {0x1F930, 0x1F939, EB}, {0x1F93A, 0x1F93B, ID},
+                {0x1F93C, 0x1F93E, EB}, {0x1F93F, 0x1F976, ID}, {0x1F977, 0x1F977, EB}, {0x1F978, 0x1F9B4, ID},
+                {0x1F9B5, 0x1F9B6, EB}, {0x1F9B7, 0x1F9B7, ID}, {0x1F9B8, 0x1F9B9, EB}, {0x1F9BA, 0x1F9BA, ID},
+                {0x1F9BB, 0x1F9BB, EB}, {0x1F9BC, 0x1F9CC, ID}, {0x1F9CD, 0x1F9CF, EB}, {0x1F9D0, 0x1F9D0, ID},
+                {0x1F9D1, 0x1F9DD, EB}, {0x1F9DE, 0x1F9FF, ID}, {0x1FA54, 0x1FAC2, ID}, {0x1FAC3, 0x1FAC5, EB},
+                {0x1FAC6, 0x1FAEF, ID}, {0x1FAF0, 0x1FAF6, EB}, {0x1FAF7, 0x1FAFF, ID}, {0x1FBF0, 0x1FBF9, NU},
+                {0x1FC00, 0x1FFFD, ID}, {0x20000, 0x2FFFD, ID}, {0x30000, 0x3FFFD, ID}, {0xE0001, 0xE0001, CM},
+                {0xE0020, 0xE007F, CM}, {0xE0100, 0xE01EF, CM},
+        });
+}();
+
+inline constexpr auto lineBreakTables =
+        makeUnicodeTables<mixedUnicodeBlocks(lineBreakRanges)>(lineBreakRanges);
+
+inline constexpr LineBreak lineBreakClass(char32_t cp) {
+    const auto value = static_cast<LineBreak>(lineBreakTables[cp]);
+    // Hangul syllables without a final consonant.
+    if (value == LineBreak::H3 && cp >= 0xAC00 && cp <= 0xD7A3 && (cp - 0xAC00) % 28 == 0) return LineBreak::H2;
+    return value;
+}
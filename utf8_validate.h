@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SUBCHAT_UTF8_SIMD 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SUBCHAT_TARGET(isa)
+#define SUBCHAT_ALWAYS_INLINE __forceinline
+#else
+// Compiles a function for an instruction set the build does not target as a whole.
+#define SUBCHAT_TARGET(isa) __attribute__((target(isa)))
+#define SUBCHAT_ALWAYS_INLINE [[gnu::always_inline]] inline
+#endif
+#endif
+
+// UTF-8 validation of chat text as it enters the renderer, so the wrapper can walk it unchecked.
+//
+// The vector path is the lookup-table algorithm of Keiser & Lemire ("Validating UTF-8 in less
+// than one instruction per byte"): three 16-entry tables, indexed by the high nibble of the
+// previous byte, the low nibble of the previous byte and the high nibble of the current byte,
+// each give the set of errors a byte pair may belong to; a pair is invalid when all three agree.
+// Missing or surplus continuation bytes of 3- and 4-byte sequences are caught separately.
+// It needs a byte shuffle (SSSE3 or AVX2), which is picked at run time unless the build targets
+// AVX2 anyway; other CPUs use a scalar decoder with an ASCII fast path.
+
+// Error classes of a (previous byte, current byte) pair.
+inline constexpr uint8_t utf8TooShort = 1 << 0; // Lead byte not followed by a continuation
+inline constexpr uint8_t utf8TooLong = 1 << 1; // ASCII followed by a continuation
+inline constexpr uint8_t utf8Overlong3 = 1 << 2;
+inline constexpr uint8_t utf8TooLarge = 1 << 3; // Above U+10FFFF
+inline constexpr uint8_t utf8Surrogate = 1 << 4;
+inline constexpr uint8_t utf8Overlong2 = 1 << 5;
+inline constexpr uint8_t utf8TooLarge1000 = 1 << 6;
+inline constexpr uint8_t utf8Overlong4 = 1 << 6;
+inline constexpr uint8_t utf8TwoConts = 1 << 7; // Two continuations in a row; only valid inside a 3/4-byte sequence
+inline constexpr uint8_t utf8Carry = utf8TooShort | utf8TooLong | utf8TwoConts;
+
+alignas(16) inline constexpr uint8_t utf8Byte1High[16] = {
+    // 0xxx: ASCII
+    utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong, utf8TooLong,
+    // 10xx: continuation
+    utf8TwoConts, utf8TwoConts, utf8TwoConts, utf8TwoConts,
+    // 1100, 1101: 2-byte lead
+    utf8TooShort | utf8Overlong2, utf8TooShort,
+    // 1110: 3-byte lead
+    utf8TooShort | utf8Overlong3 | utf8Surrogate,
+    // 1111: 4-byte lead
+    utf8TooShort | utf8TooLarge | utf8TooLarge1000 | utf8Overlong4,
+};
+
+alignas(16) inline constexpr uint8_t utf8Byte1Low[16] = {
+    utf8Carry | utf8Overlong3 | utf8Overlong2 | utf8Overlong4,
+    utf8Carry | utf8Overlong2,
+    utf8Carry,
+    utf8Carry,
+    utf8Carry | utf8TooLarge,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000 | utf8Surrogate,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+    utf8Carry | utf8TooLarge | utf8TooLarge1000,
+};
+
+alignas(16) inline constexpr uint8_t utf8Byte2High[16] = {
+    // 0xxx: ASCII
+    utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort,
+    // 1000
+    utf8TooLong | utf8Overlong2 | utf8TwoConts | utf8Overlong3 | utf8TooLarge1000 | utf8Overlong4,
+    // 1001
+    utf8TooLong | utf8Overlong2 | utf8TwoConts | utf8Overlong3 | utf8TooLarge,
+    // 101x
+    utf8TooLong | utf8Overlong2 | utf8TwoConts | utf8Surrogate | utf8TooLarge,
+    utf8TooLong | utf8Overlong2 | utf8TwoConts | utf8Surrogate | utf8TooLarge,
+    // 11xx: lead
+    utf8TooShort, utf8TooShort, utf8TooShort, utf8TooShort,
+};
+
+#ifdef SUBCHAT_UTF8_SIMD
+struct Utf8Avx2 {
+    using V = __m256i;
+    static constexpr size_t width = 32;
+
+    SUBCHAT_TARGET("avx2") static V load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    SUBCHAT_TARGET("avx2") static V set1(uint8_t b) { return _mm256_set1_epi8(static_cast<char>(b)); }
+    SUBCHAT_TARGET("avx2") static V zero() { return _mm256_setzero_si256(); }
+    SUBCHAT_TARGET("avx2") static V lookup(const uint8_t *table, V index) {
+        return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(table))), index);
+    }
+    SUBCHAT_TARGET("avx2") static V shr4(V v) { return _mm256_and_si256(_mm256_srli_epi16(v, 4), set1(0x0F)); }
+    SUBCHAT_TARGET("avx2") static V subs(V a, V b) { return _mm256_subs_epu8(a, b); }
+    SUBCHAT_TARGET("avx2") static V bitAnd(V a, V b) { return _mm256_and_si256(a, b); }
+    SUBCHAT_TARGET("avx2") static V bitOr(V a, V b) { return _mm256_or_si256(a, b); }
+    SUBCHAT_TARGET("avx2") static V bitXor(V a, V b) { return _mm256_xor_si256(a, b); }
+    SUBCHAT_TARGET("avx2") static bool isAscii(V v) { return _mm256_movemask_epi8(v) == 0; }
+    SUBCHAT_TARGET("avx2") static bool any(V v) { return !_mm256_testz_si256(v, v); }
+
+    // The current block shifted right by N bytes, with the last N bytes of 'prev' in front.
+    template<int N>
+    SUBCHAT_TARGET("avx2") static V prev(V input, V prev) {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+    }
+
+    // Bytes that, in the last three positions, start a sequence the block does not finish.
+    SUBCHAT_TARGET("avx2") static V incomplete(V input) {
+        return subs(input, _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                            static_cast<char>(0xC0 - 1)));
+    }
+};
+
+struct Utf8Ssse3 {
+    using V = __m128i;
+    static constexpr size_t width = 16;
+
+    SUBCHAT_TARGET("ssse3") static V load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    SUBCHAT_TARGET("ssse3") static V set1(uint8_t b) { return _mm_set1_epi8(static_cast<char>(b)); }
+    SUBCHAT_TARGET("ssse3") static V zero() { return _mm_setzero_si128(); }
+    SUBCHAT_TARGET("ssse3") static V lookup(const uint8_t *table, V index) {
+        return _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(table)), index);
+    }
+    SUBCHAT_TARGET("ssse3") static V shr4(V v) { return _mm_and_si128(_mm_srli_epi16(v, 4), set1(0x0F)); }
+    SUBCHAT_TARGET("ssse3") static V subs(V a, V b) { return _mm_subs_epu8(a, b); }
+    SUBCHAT_TARGET("ssse3") static V bitAnd(V a, V b) { return _mm_and_si128(a, b); }
+    SUBCHAT_TARGET("ssse3") static V bitOr(V a, V b) { return _mm_or_si128(a, b); }
+    SUBCHAT_TARGET("ssse3") static V bitXor(V a, V b) { return _mm_xor_si128(a, b); }
+    SUBCHAT_TARGET("ssse3") static bool isAscii(V v) { return _mm_movemask_epi8(v) == 0; }
+    SUBCHAT_TARGET("ssse3") static bool any(V v) { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero())) != 0xFFFF; }
+
+    template<int N>
+    SUBCHAT_TARGET("ssse3") static V prev(V input, V prev) {
+        return _mm_alignr_epi8(input, prev, 16 - N);
+    }
+
+    SUBCHAT_TARGET("ssse3") static V incomplete(V input) {
+        return subs(input, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                         static_cast<char>(0xC0 - 1)));
+    }
+};
+
+// Vector values only cross between the functions below once they are inlined into one of the
+// entry points, which are compiled for the instruction set of S.
+#ifndef _MSC_VER
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// Running state of the vector validator over consecutive blocks.
+template<typename S>
+struct Utf8SimdChecker {
+    using V = typename S::V;
+    V error;
+    V prevInput;
+    V prevIncomplete;
+
+    SUBCHAT_ALWAYS_INLINE void check(const V &input) {
+        if (S::isAscii(input)) {
+            // A sequence cut off by the end of the previous block stays cut off.
+            error = S::bitOr(error, prevIncomplete);
+            prevIncomplete = S::zero();
+        } else {
+            const V prev1 = S::template prev<1>(input, prevInput);
+            const V special = S::bitAnd(S::bitAnd(S::lookup(utf8Byte1High, S::shr4(prev1)),
+                                                  S::lookup(utf8Byte1Low, S::bitAnd(prev1, S::set1(0x0F)))),
+                                        S::lookup(utf8Byte2High, S::shr4(input)));
+            // Only the third and fourth byte of a sequence may be a second continuation in a row.
+            const V must23 = S::bitOr(S::subs(S::template prev<2>(input, prevInput), S::set1(0xE0 - 0x80)),
+                                      S::subs(S::template prev<3>(input, prevInput), S::set1(0xF0 - 0x80)));
+            error = S::bitOr(error, S::bitXor(S::bitAnd(must23, S::set1(0x80)), special));
+            prevIncomplete = S::incomplete(input);
+        }
+        prevInput = input;
+    }
+};
+
+template<typename S>
+SUBCHAT_ALWAYS_INLINE bool utf8IsValidSimd(std::string_view s) {
+    Utf8SimdChecker<S> checker{S::zero(), S::zero(), S::zero()};
+    size_t i = 0;
+    for (; i + S::width <= s.size(); i += S::width) checker.check(S::load(s.data() + i));
+    // The zero padding after the tail flags a sequence that the string ends in the middle of.
+    alignas(32) char tail[S::width] = {};
+    std::memcpy(tail, s.data() + i, s.size() - i);
+    checker.check(S::load(tail));
+    return !S::any(checker.error);
+}
+
+SUBCHAT_TARGET("avx2") inline bool utf8IsValidAvx2(std::string_view s) {
+    return utf8IsValidSimd<Utf8Avx2>(s);
+}
+
+SUBCHAT_TARGET("ssse3") inline bool utf8IsValidSsse3(std::string_view s) {
+    return utf8IsValidSimd<Utf8Ssse3>(s);
+}
+
+#ifndef _MSC_VER
+#pragma GCC diagnostic pop
+#endif
+
+// Best vector validator the CPU runs: 2 for AVX2, 1 for SSSE3, 0 for none.
+inline int utf8SimdLevel() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool ssse3 = info[2] & (1 << 9);
+    // AVX2 also needs the OS to save the YMM registers.
+    const bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    bool avx2 = false;
+    if (osAvx && maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = info[1] & (1 << 5);
+    }
+    return avx2 ? 2 : ssse3 ? 1 : 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("ssse3") ? 1 : 0;
+#endif
+}
+#endif
+
+// Length of the valid sequence at s[i], or 0 if s[i] starts an invalid one. On failure 'bad'
+// is set to the length of the maximal invalid subpart, which is what one U+FFFD replaces.
+inline size_t utf8SequenceLength(std::string_view s, size_t i, size_t &bad) {
+    const auto c = static_cast<uint8_t>(s[i]);
+    size_t length;
+    uint8_t lo = 0x80, hi = 0xBF; // Allowed range of the second byte
+    if (c < 0x80) return 1;
+    if (c >= 0xC2 && c <= 0xDF) length = 2;
+    else if (c >= 0xE0 && c <= 0xEF) {
+        length = 3;
+        if (c == 0xE0) lo = 0xA0;
+        else if (c == 0xED) hi = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        if (c == 0xF0) lo = 0x90;
+        else if (c == 0xF4) hi = 0x8F;
+    } else {
+        bad = 1;
+        return 0;
+    }
+    for (size_t k = 1; k < length; ++k) {
+        const auto b = i + k < s.size() ? static_cast<uint8_t>(s[i + k]) : 0;
+        if (b < (k == 1 ? lo : 0x80) || b > (k == 1 ? hi : 0xBF)) {
+            bad = k;
+            return 0;
+        }
+    }
+    return length;
+}
+
+inline bool utf8IsValidScalar(std::string_view s) {
+    size_t i = 0;
+    while (i < s.size()) {
+        // Skip ASCII eight bytes at a time.
+        uint64_t word;
+        if (i + 8 <= s.size() && (std::memcpy(&word, s.data() + i, 8), (word & 0x8080808080808080ull) == 0)) {
+            i += 8;
+            continue;
+        }
+        size_t bad;
+        const size_t length = utf8SequenceLength(s, i, bad);
+        if (length == 0) return false;
+        i += length;
+    }
+    return true;
+}
+
+// Whether s is valid UTF-8.
+inline bool utf8IsValid(std::string_view s) {
+#if defined(__AVX2__)
+    return utf8IsValidAvx2(s);
+#elif defined(SUBCHAT_UTF8_SIMD)
+    static const int level = utf8SimdLevel();
+    if (level == 2) return utf8IsValidAvx2(s);
+    if (level == 1) return utf8IsValidSsse3(s);
+    return utf8IsValidScalar(s);
+#else
+    return utf8IsValidScalar(s);
+#endif
+}
+
+// Returns s if it is valid UTF-8. Otherwise builds a copy in 'scratch' in which every maximal
+// invalid subpart (as defined by the Unicode standard) is replaced by U+FFFD, and returns that.
+inline std::string_view utf8Sanitize(std::string_view s, std::string &scratch) {
+    if (utf8IsValid(s)) return s;
+    scratch.clear();
+    size_t i = 0;
+    while (i < s.size()) {
+        size_t bad = 0;
+        const size_t length = utf8SequenceLength(s, i, bad);
+        if (length == 0) {
+            scratch += "\xEF\xBF\xBD";
+            i += bad;
+        } else {
+            scratch.append(s, i, length);
+            i += length;
+        }
+    }
+    return scratch;
+}
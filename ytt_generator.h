@@ -1,196 +1,195 @@
 #pragma once
 
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
 #include <iostream>
-#include <sstream>
 #include <iomanip>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <fstream>
 #include <cctype>
 #include <filesystem>
 #include <optional>
 #include <iterator>
+#include <list>
 #include <queue>
+#include <set>
+#include <thread>
 #include <ranges>
+#include <unordered_map>
+#include "text_arena.h"
 #include "utf8.h"
+#include "utf8_validate.h"
+#include "text_scanner.h"
+#include "display_width.h"
+#include "line_break.h"
+#include "line_metrics.h"
 #include "tinyxml2.h"
 #include "SimpleIni.h"
 #include "magic_enum.hpp"
 #include <format>
 
-// Returns the number of UTF‑8 code points in s.
-inline int utf8_length(const std::string &s) {
-    return static_cast<int>(utf8::distance(s.begin(), s.end()));
-}
+// Value of every hex digit character; other characters count as 0.
+inline constexpr std::array<uint8_t, 256> hexDigitValues = [] {
+    std::array<uint8_t, 256> values{};
+    for (int c = '0'; c <= '9'; ++c) values[c] = static_cast<uint8_t>(c - '0');
+    for (int c = 'A'; c <= 'F'; ++c) values[c] = static_cast<uint8_t>(c - 'A' + 10);
+    for (int c = 'a'; c <= 'f'; ++c) values[c] = static_cast<uint8_t>(c - 'a' + 10);
+    return values;
+}();
+
+// The two uppercase hex digits of every byte value.
+inline constexpr std::array<std::array<char, 2>, 256> hexBytePairs = [] {
+    constexpr char digits[] = "0123456789ABCDEF";
+    std::array<std::array<char, 2>, 256> pairs{};
+    for (int i = 0; i < 256; ++i) pairs[i] = {digits[i >> 4], digits[i & 15]};
+    return pairs;
+}();
+
+// RGBA color packed as 0xRRGGBBAA, so it compares and hashes as a single integer.
+// Every channel is clamped to maxValue.
+struct Color {
+    static constexpr int maxValue = 254;
+    typedef unsigned char cType;
 
-// Returns the first 'count' UTF‑8 code points of s.
-inline std::string utf8_substr(const std::string &s, int count) {
-    auto it = s.begin();
-    int i = 0;
-    while (it != s.end() && i < count) {
-        utf8::next(it, s.end());
-        ++i;
-    }
-    return {s.begin(), it};
-}
+    static constexpr size_t hexSize = 9; // "#RRGGBBAA"
+    static constexpr size_t assSize = 20; // "{\c&HBBGGRR&\a&HAA&}"
 
-// Returns the remainder of s after consuming the first 'count' UTF‑8 code points.
-inline std::string utf8_consume(const std::string &s, int count) {
-    auto it = s.begin();
-    int i = 0;
-    while (it != s.end() && i < count) {
-        utf8::next(it, s.end());
-        ++i;
-    }
-    return {it, s.end()};
-}
+    uint32_t rgba = 0;
 
-template<typename T, T Max>
-struct Clamped {
-    T value;
+    Color() = default;
 
-    Clamped(T v = 0) : value(clamp(v)) {
+    constexpr Color(cType red, cType green, cType blue, cType alpha = maxValue)
+        : rgba(uint32_t{clamp(red)} << 24 | uint32_t{clamp(green)} << 16 | uint32_t{clamp(blue)} << 8 | clamp(alpha)) {
     }
 
-    static T clamp(T v) {
-        return (v > Max) ? Max : v;
+    Color(const std::string &hexCode) {
+        parseHex(hexCode);
     }
 
-    operator T() const {
-        return value;
+    Color(const char *hexCode) {
+        if (hexCode) parseHex(hexCode);
     }
 
-    Clamped &operator=(T v) {
-        value = clamp(v);
-        return *this;
+    Color(std::string_view hexCode) {
+        parseHex(hexCode);
     }
-};
-
-struct Color {
-    static constexpr int maxValue = 254;
-    typedef unsigned char cType;
 
-    Clamped<cType, maxValue> r;
-    Clamped<cType, maxValue> g;
-    Clamped<cType, maxValue> b;
-    Clamped<cType, maxValue> a;
-
-
-    static int hexToInt(char c) {
-        if (c >= '0' && c <= '9') return c - '0';
-        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-        return 0;
+    constexpr cType r() const {
+        return static_cast<cType>(rgba >> 24);
     }
 
+    constexpr cType g() const {
+        return static_cast<cType>(rgba >> 16);
+    }
 
-    void parseHex(const std::string &hex) {
-        if (hex.empty()) return;
-
-        std::string cleaned = hex;
-        if (cleaned[0] == '#') {
-            cleaned = cleaned.substr(1);
-        }
-
-        // Convert to uppercase for consistency
-        std::ranges::transform(cleaned, cleaned.begin(), ::toupper);
+    constexpr cType b() const {
+        return static_cast<cType>(rgba >> 8);
+    }
 
-        // Support formats:
-        // - #RGB : 3-digit, assume opaque (alpha = maxValue)
-        // - #RGBA : 4-digit, includes alpha
-        // - #RRGGBB : 6-digit, assume opaque
-        // - #RRGGBBAA : 8-digit, includes alpha
-        if (cleaned.length() == 3) {
-            r = static_cast<cType>(hexToInt(cleaned[0]) * 16 + hexToInt(cleaned[0]));
-            g = static_cast<cType>(hexToInt(cleaned[1]) * 16 + hexToInt(cleaned[1]));
-            b = static_cast<cType>(hexToInt(cleaned[2]) * 16 + hexToInt(cleaned[2]));
-            a = maxValue;
-        } else if (cleaned.length() == 4) {
-            r = static_cast<cType>(hexToInt(cleaned[0]) * 16 + hexToInt(cleaned[0]));
-            g = static_cast<cType>(hexToInt(cleaned[1]) * 16 + hexToInt(cleaned[1]));
-            b = static_cast<cType>(hexToInt(cleaned[2]) * 16 + hexToInt(cleaned[2]));
-            a = static_cast<cType>(hexToInt(cleaned[3]) * 16 + hexToInt(cleaned[3]));
-        } else if (cleaned.length() == 6) {
-            r = static_cast<cType>(hexToInt(cleaned[0]) * 16 + hexToInt(cleaned[1]));
-            g = static_cast<cType>(hexToInt(cleaned[2]) * 16 + hexToInt(cleaned[3]));
-            b = static_cast<cType>(hexToInt(cleaned[4]) * 16 + hexToInt(cleaned[5]));
-            a = maxValue;
-        } else if (cleaned.length() == 8) {
-            r = static_cast<cType>(hexToInt(cleaned[0]) * 16 + hexToInt(cleaned[1]));
-            g = static_cast<cType>(hexToInt(cleaned[2]) * 16 + hexToInt(cleaned[3]));
-            b = static_cast<cType>(hexToInt(cleaned[4]) * 16 + hexToInt(cleaned[5]));
-            a = static_cast<cType>(hexToInt(cleaned[6]) * 16 + hexToInt(cleaned[7]));
-        }
+    constexpr cType a() const {
+        return static_cast<cType>(rgba);
     }
 
-    Color() = default;
+    static constexpr cType clamp(cType v) {
+        return v > maxValue ? maxValue : v;
+    }
 
-    Color(cType red, cType green, cType blue, cType alpha = maxValue)
-        : r(red), g(green), b(blue), a(alpha) {
+    // Support formats:
+    // - #RGB : 3-digit, assume opaque (alpha = maxValue)
+    // - #RGBA : 4-digit, includes alpha
+    // - #RRGGBB : 6-digit, assume opaque
+    // - #RRGGBBAA : 8-digit, includes alpha
+    // Anything else leaves the color unchanged.
+    void parseHex(std::string_view cleaned) {
+        if (!cleaned.empty() && cleaned[0] == '#') cleaned.remove_prefix(1);
+        const size_t n = cleaned.size();
+        if (n != 3 && n != 4 && n != 6 && n != 8) return;
+        // In the short forms every digit stands for both digits of its channel.
+        const size_t step = n <= 4 ? 1 : 2;
+        const size_t low = step - 1;
+        auto channel = [&](size_t i) {
+            return static_cast<cType>(hexDigitValues[static_cast<uint8_t>(cleaned[i * step])] * 16 +
+                                      hexDigitValues[static_cast<uint8_t>(cleaned[i * step + low])]);
+        };
+        *this = Color(channel(0), channel(1), channel(2), n == 4 || n == 8 ? channel(3) : maxValue);
     }
 
-    Color(const std::string &hexCode) {
-        parseHex(hexCode);
+    // Writes the color as #RRGGBB, or #RRGGBBAA unless alpha is maxValue, into 'out'
+    // (room for hexSize characters, no terminator) and returns the end.
+    char *formatHex(char *out) const {
+        *out++ = '#';
+        out = putByte(out, r());
+        out = putByte(out, g());
+        out = putByte(out, b());
+        if (a() != maxValue) out = putByte(out, a());
+        return out;
     }
 
-    Color(const char *hexCode) {
-        if (hexCode) parseHex(hexCode);
+    // Writes the ASS override block for the color, {\c&HBBGGRR&} with \a&HAA& added unless
+    // alpha is maxValue, into 'out' (room for assSize characters) and returns the end.
+    char *formatAss(char *out) const {
+        out = put(out, "{\\c&H");
+        out = putByte(out, b());
+        out = putByte(out, g());
+        out = putByte(out, r());
+        *out++ = '&';
+        if (a() != maxValue) {
+            out = put(out, "\\a&H");
+            out = putByte(out, a());
+            *out++ = '&';
+        }
+        *out++ = '}';
+        return out;
     }
 
-    // Convert to hex string (always uppercase with #)
-    // If alpha is maxValue, the output will be in #RRGGBB format;
-    // otherwise, it will include alpha as #RRGGBBAA.
     std::string toHexString() const {
-        std::stringstream ss;
-        ss << '#' << std::uppercase << std::hex << std::setfill('0')
-                << std::setw(2) << static_cast<int>(r)
-                << std::setw(2) << static_cast<int>(g)
-                << std::setw(2) << static_cast<int>(b);
-        if (a != maxValue) {
-            ss << std::setw(2) << static_cast<int>(a);
-        }
-        return ss.str();
+        char buf[hexSize];
+        return {buf, formatHex(buf)};
     }
 
     operator std::string() const {
         return toHexString();
     }
 
+    std::string toAssColor() const {
+        char buf[assSize];
+        return {buf, formatAss(buf)};
+    }
+
     bool operator==(const Color &other) const {
-        return r == other.r && g == other.g && b == other.b && a == other.a;
+        return rgba == other.rgba;
     }
 
     bool operator!=(const Color &other) const {
-        return !(*this == other);
+        return rgba != other.rgba;
     }
 
+    // Orders by r, then g, b and a.
     bool operator<(const Color &other) const {
-        if (r != other.r) return r < other.r;
-        if (g != other.g) return g < other.g;
-        if (b != other.b) return b < other.b;
-        return a < other.a;
+        return rgba < other.rgba;
     }
 
-    std::string toAssColor() const {
-        std::stringstream ss;
-        ss << "{\\c&H"
-                << std::uppercase << std::hex << std::setfill('0')
-                << std::setw(2) << static_cast<int>(b)
-                << std::setw(2) << static_cast<int>(g)
-                << std::setw(2) << static_cast<int>(r)
-                << "&";
-
-        // Here we check if alpha is not equal to maxValue (opaque).
-        // If you want to force output alpha, simply output it.
-        if (a != maxValue) {
-            ss << "\\a&H"
-                    << std::setw(2) << static_cast<int>(a)
-                    << "&";
-        }
-        ss << "}";
-        return ss.str();
+private:
+    static char *putByte(char *out, cType value) {
+        *out++ = hexBytePairs[value][0];
+        *out++ = hexBytePairs[value][1];
+        return out;
+    }
+
+    template<size_t N>
+    static char *put(char *out, const char (&text)[N]) {
+        std::memcpy(out, text, N - 1);
+        return out + N - 1;
     }
 };
 
@@ -280,6 +279,25 @@ struct ChatParams {
     int maxCharsPerLine = 25;
     std::string usernameSeparator = ":";
 
+    // How text is measured for wrapping in the chosen font.
+    LineMetrics lineMetrics() const {
+        switch (fontStyle) {
+            case FontStyle::Proportional:
+                return {serifFontMetrics, maxCharsPerLine};
+            case FontStyle::Cursive:
+                return {cursiveFontMetrics, maxCharsPerLine};
+            case FontStyle::SmallCapitals:
+                return {smallCapsFontMetrics, maxCharsPerLine};
+            case FontStyle::Casual:
+                return {comicSansFontMetrics, maxCharsPerLine};
+            case FontStyle::Default: // Shows Roboto
+            case FontStyle::ProportionalSans:
+                return {robotoFontMetrics, maxCharsPerLine};
+            default: // Monospaced fonts
+                return LineMetrics(maxCharsPerLine);
+        }
+    }
+
     void saveToFile(const char *filename) const {
         CSimpleIniCaseA ini;
         ini.SetUnicode();
@@ -335,7 +353,7 @@ struct ChatParams {
                          ";lines");
 
         ini.SetLongValue(S, "maxCharsPerLine", maxCharsPerLine,
-                         ";characters");
+                         ";characters of Lucida Console; in monospaced fonts CJK characters and emoji take two");
         ini.SetValue(S, "usernameSeparator", usernameSeparator.c_str(),
                      ";string between name and message");
 
@@ -414,313 +432,1073 @@ struct ChatParams {
     }
 };
 
+// Colors for users whose messages carry none, as 0xRRGGBB.
+inline constexpr uint32_t defaultUserColors[] = {
+    0xff0000, 0x0000ff, 0x008000, 0xb22222, 0xff7f50,
+    0x9acd32, 0xff4500, 0x2e8b57, 0xdaa520, 0xd2691e,
+    0x5f9ea0, 0x1e90ff, 0xff69b4, 0x8a2be2, 0x00ff7f
+};
+
+// 64-bit FNV-1a. Unlike std::hash, its values are the same with every standard library.
+inline constexpr uint64_t fnv1a(std::string_view s) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const char c: s) hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+    return hash;
+}
+
+// The palette color of a user without a color of their own. It only depends on the name,
+// so a user gets the same color in every build and on every platform.
+inline Color getRandomColor(std::string_view username) {
+    const uint32_t rgb = defaultUserColors[fnv1a(username) % std::size(defaultUserColors)];
+    return Color(static_cast<Color::cType>(rgb >> 16), static_cast<Color::cType>(rgb >> 8),
+                 static_cast<Color::cType>(rgb));
+}
+
 struct User {
-    std::string name;
+    std::string_view name;
     Color color;
 };
 
+// Every distinct (name, color) pair seen while parsing, stored once and referred to by id.
+// A busy channel has tens of thousands of chatters but millions of messages, so messages
+// and wrapped lines carry a 32-bit id instead of their own copy of the user.
+class UserTable {
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    UserTable() = default;
+    UserTable(UserTable &&) = default;
+    UserTable &operator=(UserTable &&) = default;
+
+    // Returns the id of the user, adding it on first sight. The name is copied into the table,
+    // with invalid UTF-8 replaced; it is only checked the first time it is seen.
+    uint32_t intern(std::string_view name, const Color &color) {
+        auto it = ids_.find(Key{name, color.rgba});
+        if (it != ids_.end()) return it->second;
+        std::string repaired;
+        name = utf8Sanitize(name, repaired);
+        if (!repaired.empty()) {
+            it = ids_.find(Key{name, color.rgba});
+            if (it != ids_.end()) return it->second;
+        }
+        const auto id = static_cast<uint32_t>(users_.size());
+        const std::string_view stored = names_.store(name);
+        users_.push_back(User{stored, color});
+        ids_.emplace(Key{stored, color.rgba}, id);
+        return id;
+    }
+
+    // Like intern() with the name's palette color (see getRandomColor). The id is remembered
+    // per name, so later messages of the user cost a single lookup.
+    uint32_t internDefault(std::string_view name) {
+        const auto it = defaultIds_.find(name);
+        if (it != defaultIds_.end()) return it->second;
+        const uint32_t id = intern(name, getRandomColor(name));
+        defaultIds_.emplace(users_[id].name, id);
+        return id;
+    }
+
+    // Adds every user of 'other' and returns, for each of its ids, the id in this table.
+    std::vector<uint32_t> merge(const UserTable &other) {
+        std::vector<uint32_t> ids(other.size());
+        for (uint32_t i = 0; i < other.size(); ++i) ids[i] = intern(other[i].name, other[i].color);
+        return ids;
+    }
 
-// A single parsed chat message.
+    const User &operator[](uint32_t id) const {
+        return users_[id];
+    }
+
+    size_t size() const {
+        return users_.size();
+    }
+
+private:
+    struct Key {
+        std::string_view name;
+        uint32_t color;
+
+        bool operator==(const Key &) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return std::hash<std::string_view>{}(key.name) ^ (key.color * size_t{0x9E3779B97F4A7C15});
+        }
+    };
+
+    TextArena names_;
+    std::vector<User> users_;
+    std::unordered_map<Key, uint32_t, KeyHash> ids_;
+    std::unordered_map<std::string_view, uint32_t> defaultIds_; // Name -> id with the palette color
+};
+
+// A single parsed chat message. The text is a view into the storage of the log it came
+// from (see ChatLog), so it must not outlive it; the user is an id into a UserTable.
 struct ChatMessage {
     uint64_t time = 0; // Timestamp in milliseconds
-    User user;
-    std::string message;
+    uint32_t user = UserTable::none;
+    std::string_view message;
+};
+
+// Makes the message texts a source hands out valid UTF-8 (see utf8Sanitize), so that everything
+// after the sources can walk text unchecked. A repaired text is valid until the next call. The
+// messages repaired in the last pass are reported when the source goes away.
+class Utf8Repair {
+public:
+    Utf8Repair() = default;
+    Utf8Repair(const Utf8Repair &) = delete;
+    Utf8Repair &operator=(const Utf8Repair &) = delete;
+
+    ~Utf8Repair() {
+        if (repaired_ > 0) std::cerr << "Warning: Replaced invalid UTF-8 in " << repaired_ << " messages.\n";
+    }
+
+    std::string_view operator()(std::string_view text) {
+        const std::string_view valid = utf8Sanitize(text, scratch_);
+        if (valid.data() != text.data()) ++repaired_;
+        return valid;
+    }
+
+    // Starts a new pass.
+    void rewind() {
+        repaired_ = 0;
+    }
+
+private:
+    std::string scratch_;
+    size_t repaired_ = 0;
+};
+
+// Pull-based stream of chat messages in timestamp order.
+// User ids refer to the UserTable the source was given; message text is valid UTF-8, and valid
+// only until the next call to next().
+class ChatSource {
+public:
+    virtual ~ChatSource() = default;
+
+    // Reads the next message into msg. Returns false once the source is exhausted.
+    virtual bool next(ChatMessage &msg) = 0;
+
+    // Restarts from the first message. Returns false if the source cannot be replayed.
+    virtual bool rewind() {
+        return false;
+    }
+
+    // Whether the last pass stopped early because the input could not be read or parsed.
+    virtual bool failed() const {
+        return false;
+    }
+};
+
+// Serves messages from an already materialized vector.
+class VectorChatSource : public ChatSource {
+public:
+    explicit VectorChatSource(const std::vector<ChatMessage> &messages) : messages_(messages) {
+    }
+
+    bool next(ChatMessage &msg) override {
+        if (pos_ >= messages_.size()) return false;
+        msg = messages_[pos_++];
+        return true;
+    }
+
+    bool rewind() override {
+        pos_ = 0;
+        return true;
+    }
+
+private:
+    const std::vector<ChatMessage> &messages_;
+    size_t pos_ = 0;
 };
 
-// A single wrapped chat line.
+// Makes a source that can only be read once (such as standard input) replayable: messages are
+// copied as they pass through, and rewind() serves the copies before reading further.
+class ReplayChatSource : public ChatSource {
+public:
+    explicit ReplayChatSource(std::unique_ptr<ChatSource> inner) : inner_(std::move(inner)) {
+    }
+
+    bool next(ChatMessage &msg) override {
+        if (pos_ < messages_.size()) {
+            msg = messages_[pos_++];
+            return true;
+        }
+        if (!inner_->next(msg)) return false;
+        msg.message = text_.store(msg.message);
+        messages_.push_back(msg);
+        ++pos_;
+        return true;
+    }
+
+    bool rewind() override {
+        pos_ = 0;
+        return true;
+    }
+
+    bool failed() const override {
+        return inner_->failed();
+    }
+
+private:
+    std::unique_ptr<ChatSource> inner_;
+    TextArena text_;
+    std::vector<ChatMessage> messages_;
+    size_t pos_ = 0;
+};
+
+// Passes on the messages of another source that fall into [from, to], shifted so that 'from' becomes 0.
+// Used to render a clip out of a longer log.
+class TimeRangeChatSource : public ChatSource {
+public:
+    TimeRangeChatSource(std::unique_ptr<ChatSource> inner, uint64_t from, uint64_t to)
+        : inner_(std::move(inner)), from_(from), to_(to) {
+    }
+
+    bool next(ChatMessage &msg) override {
+        while (inner_->next(msg)) {
+            if (msg.time < from_ || msg.time > to_) continue;
+            msg.time -= from_;
+            return true;
+        }
+        return false;
+    }
+
+    bool rewind() override {
+        return inner_->rewind();
+    }
+
+    bool failed() const override {
+        return inner_->failed();
+    }
+
+private:
+    std::unique_ptr<ChatSource> inner_;
+    uint64_t from_;
+    uint64_t to_;
+};
+
+// Shifts the messages of another source by 'offset' milliseconds, e.g. to line up a stream that
+// started later than the others. Messages that would land before 0 are dropped.
+class OffsetChatSource : public ChatSource {
+public:
+    OffsetChatSource(std::unique_ptr<ChatSource> inner, int64_t offset) : inner_(std::move(inner)), offset_(offset) {
+    }
+
+    bool next(ChatMessage &msg) override {
+        while (inner_->next(msg)) {
+            if (offset_ < 0 && msg.time < static_cast<uint64_t>(-offset_)) continue;
+            msg.time += static_cast<uint64_t>(offset_);
+            return true;
+        }
+        return false;
+    }
+
+    bool rewind() override {
+        return inner_->rewind();
+    }
+
+    bool failed() const override {
+        return inner_->failed();
+    }
+
+private:
+    std::unique_ptr<ChatSource> inner_;
+    int64_t offset_;
+};
+
+// Interleaves several time-ordered sources into one, e.g. the chats of a stream simulcast to
+// several platforms. Each source contributes its next message to a min-heap on (time, source
+// index), so equal times come out in the order the sources were given. A source is only
+// advanced after its message has been handed out, which keeps the borrowed texts valid.
+class MergedChatSource : public ChatSource {
+public:
+    explicit MergedChatSource(std::vector<std::unique_ptr<ChatSource> > inputs)
+        : inputs_(std::move(inputs)), heads_(inputs_.size()) {
+    }
+
+    bool next(ChatMessage &msg) override {
+        if (!started_) start();
+        if (last_ < inputs_.size()) advance(last_);
+        last_ = none;
+        if (heap_.empty()) return false;
+        last_ = heap_.top().second;
+        heap_.pop();
+        msg = heads_[last_];
+        return true;
+    }
+
+    bool rewind() override {
+        for (auto &input: inputs_)
+            if (!input->rewind()) return false;
+        started_ = false;
+        return true;
+    }
+
+    bool failed() const override {
+        return std::ranges::any_of(inputs_, [](const auto &input) { return input->failed(); });
+    }
+
+private:
+    static constexpr size_t none = SIZE_MAX;
+    using HeapItem = std::pair<uint64_t, size_t>;
+
+    void start() {
+        started_ = true;
+        heap_ = {};
+        last_ = none;
+        for (size_t i = 0; i < inputs_.size(); ++i) advance(i);
+    }
+
+    void advance(size_t i) {
+        if (inputs_[i]->next(heads_[i])) heap_.emplace(heads_[i].time, i);
+    }
+
+    std::vector<std::unique_ptr<ChatSource> > inputs_;
+    std::vector<ChatMessage> heads_; // Current message of each input, while it is in the heap
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<> > heap_;
+    size_t last_ = none; // Input whose message was returned last and still has to be advanced
+    bool started_ = false;
+};
+
+// Parses a clock time such as "03:10:00", "10:00.5" or "90" (seconds) into milliseconds.
+inline bool parseClockTime(std::string_view text, uint64_t &ms) {
+    uint64_t total = 0;
+    int fields = 0;
+    while (true) {
+        const size_t colon = text.find(':');
+        const std::string_view field = text.substr(0, colon);
+        if (colon == std::string_view::npos) {
+            // The last field holds the seconds and may have a fraction.
+            const size_t dot = field.find('.');
+            uint64_t seconds = 0;
+            const std::string_view whole = field.substr(0, dot);
+            auto [ptr, ec] = std::from_chars(whole.data(), whole.data() + whole.size(), seconds);
+            if (ec != std::errc() || ptr != whole.data() + whole.size()) return false;
+            uint64_t millis = 0;
+            if (dot != std::string_view::npos) {
+                const std::string_view fraction = field.substr(dot + 1);
+                if (fraction.empty() || fraction.size() > 3) return false;
+                auto [p, e] = std::from_chars(fraction.data(), fraction.data() + fraction.size(), millis);
+                if (e != std::errc() || p != fraction.data() + fraction.size()) return false;
+                for (size_t i = fraction.size(); i < 3; ++i) millis *= 10;
+            }
+            if (fields > 0 && seconds >= 60) return false;
+            ms = (total * 60 + seconds) * 1000 + millis;
+            return true;
+        }
+        uint64_t value = 0;
+        auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+        if (ec != std::errc() || ptr != field.data() + field.size() || ++fields > 2) return false;
+        if (fields > 1 && value >= 60) return false;
+        total = total * 60 + value;
+        text.remove_prefix(colon + 1);
+    }
+}
+
+// A single wrapped chat line. Only the first line of a message shows the user. The text lives in
+// one of the arenas of the batch the line belongs to.
 struct ChatLine {
-    std::optional<User> user;
-    std::string text;
+    uint32_t user = UserTable::none;
+    std::string_view text;
+
+    bool hasUser() const {
+        return user != UserTable::none;
+    }
 };
 
 // A batch represents the current accumulated chat lines at a given timestamp.
 struct Batch {
     int time;
-    std::deque<ChatLine> lines;
+    std::vector<ChatLine> lines;
+    std::vector<std::shared_ptr<const TextArena> > storage; // Holds the text of 'lines'
 };
 
-inline std::pair<std::string, std::vector<std::string> > wrapMessage(std::string username,
-                                                                     std::string separator,
-                                                                     const std::string &message,
-                                                                     int maxWidth) {
-    std::vector<std::string> lines;
-    int availableSpace = maxWidth;
-    if (utf8_length(username) > maxWidth) {
-        username = utf8_substr(username, maxWidth);
-        lines.push_back("");
-    } else {
-        availableSpace -= utf8_length(username);
+// The lines of a wrapped message, back to back in one string, so wrapping a message allocates
+// nothing once the buffers have grown.
+struct WrappedLines {
+    std::string text;
+    std::vector<size_t> ends; // End of each line in text
+
+    size_t size() const {
+        return ends.size();
+    }
+
+    bool empty() const {
+        return ends.empty();
+    }
+
+    std::string_view operator[](size_t i) const {
+        const size_t begin = i == 0 ? 0 : ends[i - 1];
+        return std::string_view(text).substr(begin, ends[i] - begin);
+    }
+
+    void clear() {
+        text.clear();
+        ends.clear();
+    }
+
+    void newLine() {
+        ends.push_back(text.size());
+    }
+
+    // Appends to the last line.
+    void append(std::string_view s) {
+        text += s;
+        ends.back() = text.size();
+    }
+
+    void append(char c) {
+        text += c;
+        ends.back() = text.size();
     }
+};
+
+// The part of a username that is shown: names wider than a whole line are cut to fit.
+inline std::string_view wrapUsername(std::string_view username, const LineMetrics &metrics) {
+    int width;
+    return username.substr(0, metrics.prefix(username, metrics.lineWidth(), width));
+}
+
+// Width the username takes in front of the first line, or -1 if it is cut to fit and so fills
+// a line of its own. This is all of the username that wrapping depends on.
+inline int usernameLineWidth(std::string_view username, const LineMetrics &metrics) {
+    int width;
+    return metrics.prefix(username, metrics.lineWidth(), width) < username.size() ? -1 : width;
+}
 
-    if (utf8_length(separator) > availableSpace) {
-        separator = utf8_substr(separator, availableSpace);
+// Wraps a message into lines no wider than metrics.lineWidth() (see line_metrics.h); the first
+// line is the rest of the username's line (see usernameLineWidth) and starts with the separator.
+// Words are found in one pass over the message, a block at a time. A word that does not fit on the
+// current line is broken where UAX #14 allows (see line_break.h), and pieces wider than a line are
+// cut between grapheme clusters by byte offset, so the cost stays linear. ASCII words, the common
+// case, are measured without looking for clusters. The lines replace the contents of 'lines'.
+inline void wrapLines(int usernameWidth, std::string_view separator, std::string_view message,
+                      const LineMetrics &metrics, WrappedLines &lines) {
+    lines.clear();
+    const int maxWidth = metrics.lineWidth();
+    const int spaceWidth = metrics.spaceWidth();
+    int availableSpace = maxWidth;
+    if (usernameWidth < 0) {
+        lines.newLine();
+    } else {
+        availableSpace -= usernameWidth;
     }
-    lines.push_back(separator);
-    availableSpace -= utf8_length(separator);
 
+    int separatorWidth;
+    lines.newLine();
+    lines.append(separator.substr(0, metrics.prefix(separator, availableSpace, separatorWidth)));
+    availableSpace -= separatorWidth;
 
-    std::istringstream iss(message);
-    std::vector<std::string> words;
-    std::string word;
     bool firstWord = true;
-    while (iss >> word) {
-        bool bigWord = false;
-        while (utf8_length(word) > maxWidth) {
-            bigWord = true;
-            if (availableSpace < 2) {
-                availableSpace = maxWidth;
-                lines.push_back(utf8_substr(word, availableSpace));
-                firstWord = false;
-            } else {
-                if (!firstWord) {
-                    lines.back() += " ";
-                    availableSpace--;
-                }
-                lines.back() += utf8_substr(word, availableSpace);
-                firstWord = false;
+    WordScanner scanner(message);
+    size_t pos = 0;
+    while ((pos = scanner.skipSpaces(pos)) < message.size()) {
+        bool ascii = true;
+        const size_t end = scanner.wordEnd(pos, ascii);
+        const std::string_view word = message.substr(pos, end - pos);
+        pos = end;
+        const int length = ascii ? metrics.asciiWidth(word) : metrics.width(word);
+
+        if (length + spaceWidth <= availableSpace) {
+            if (!firstWord) {
+                lines.append(' ');
+                availableSpace -= spaceWidth;
             }
-            word = utf8_consume(word, availableSpace); // add split
-            availableSpace = 0;
-        }
-        if (bigWord) {
-            //if (utf8_length(word) < availableSpace) word += " ";
-            lines.push_back(word);
-            availableSpace = maxWidth - utf8_length(word);
+            lines.append(word);
+            availableSpace -= length;
             firstWord = false;
             continue;
         }
-        if (utf8_length(word) < availableSpace) {
-            if (!firstWord) {
-                lines.back() += " ";
-                availableSpace--;
+
+        bool firstPiece = true;
+        forEachLineSegment(word, ascii, [&](std::string_view piece) {
+            int pieceLength = piece.size() == word.size() ? length
+                              : ascii ? metrics.asciiWidth(piece)
+                              : metrics.width(piece);
+            // Only the first piece of a word follows a space.
+            const bool spaced = firstPiece && !firstWord;
+            if (pieceLength + (firstPiece ? spaceWidth : 0) <= availableSpace) {
+                if (spaced) {
+                    lines.append(' ');
+                    availableSpace -= spaceWidth;
+                }
+                lines.append(piece);
+                availableSpace -= pieceLength;
+            } else if (pieceLength <= maxWidth) {
+                lines.newLine();
+                lines.append(piece);
+                availableSpace = maxWidth - pieceLength;
+            } else {
+                // Size of the front of the piece that fits into 'width'; its width goes to 'taken'.
+                auto fit = [&](int width, int &taken) -> size_t {
+                    return ascii ? metrics.asciiPrefix(piece, width, taken) : metrics.prefix(piece, width, taken);
+                };
+                // Fill the rest of the current line (or a new one) and break the piece there,
+                // until what is left fits on a line of its own.
+                bool space = spaced;
+                while (pieceLength > maxWidth) {
+                    int taken = 0;
+                    size_t size = availableSpace <= spaceWidth
+                                      ? 0
+                                      : fit(availableSpace - (space ? spaceWidth : 0), taken);
+                    if (size == 0) {
+                        lines.newLine();
+                        size = fit(maxWidth, taken);
+                        if (size == 0) {
+                            // A cluster wider than a whole line goes on one by itself.
+                            const Grapheme g = metrics.graphemeAt(piece, 0);
+                            size = g.size;
+                            taken = g.width;
+                        }
+                    } else if (space) {
+                        lines.append(' ');
+                    }
+                    lines.append(piece.substr(0, size));
+                    space = false;
+                    piece.remove_prefix(size);
+                    pieceLength -= taken;
+                    availableSpace = 0;
+                }
+                if (!piece.empty()) {
+                    lines.newLine();
+                    lines.append(piece);
+                    availableSpace = maxWidth - pieceLength;
+                }
             }
-            lines.back() += word;
-            availableSpace -= utf8_length(word);
-        } else {
-            //if (utf8_length(word) < maxWidth) word += " ";
-            lines.push_back(word);
-            availableSpace = maxWidth - utf8_length(word);
-        }
+            firstPiece = false;
+        });
         firstWord = false;
     }
-    //    for (const auto& line :lines){
-    //        assert(utf8_length(line)<=maxWidth);
-    //    }
-    return {username, lines};
 }
 
-inline std::vector<Batch> generateBatches(const std::vector<ChatMessage> &messages, const ChatParams &params) {
-    std::vector<Batch> batches;
-    std::deque<ChatLine> currentLines;
-    for (const auto &msg: messages) {
-        auto [username, wrapped] = wrapMessage(msg.user.name, params.usernameSeparator, msg.message,
-                                               params.maxCharsPerLine);
-        if (wrapped.empty())
-            continue;
+// The shown username (see wrapUsername) and the lines of a message.
+inline std::pair<std::string, WrappedLines> wrapMessage(std::string_view fullUsername, std::string_view separator,
+                                                        std::string_view message, const LineMetrics &metrics) {
+    const std::string_view username = wrapUsername(fullUsername, metrics);
+    const int usernameWidth = username.size() < fullUsername.size() ? -1 : metrics.width(username);
+    WrappedLines lines;
+    wrapLines(usernameWidth, separator, message, metrics, lines);
+    return {std::string(username), std::move(lines)};
+}
 
-        currentLines.emplace_back(std::make_optional<User>(username, msg.user.color), wrapped[0]);
-        if (currentLines.size() > params.totalDisplayLines) currentLines.pop_front();
-        for (size_t i = 1; i < wrapped.size(); ++i) {
-            currentLines.emplace_back(std::nullopt, wrapped[i]);
-            if (currentLines.size() > params.totalDisplayLines) currentLines.pop_front();
+// Entries WrapCache keeps by default.
+inline constexpr size_t wrapCacheSize = 1 << 14;
+
+// Remembers the lines of recently wrapped messages, for the moments when many chatters post the
+// same text (emote walls, copypastas). Lines only depend on the text and the username's width,
+// the separator and line width being fixed per cache. A text is only kept once it has been seen
+// before, so a chat of unique messages does not churn the cache; the least recently used entries
+// are dropped beyond 'capacity'.
+class WrapCache {
+public:
+    WrapCache(std::string separator, const LineMetrics &metrics, size_t capacity = wrapCacheSize)
+        : separator_(std::move(separator)), metrics_(metrics), capacity_(std::max<size_t>(capacity, 1)),
+          seen_(capacity_) {
+    }
+
+    // Lines of the message as wrapMessage returns them. They stay valid until the next call.
+    const WrappedLines &wrap(std::string_view username, std::string_view message) {
+        ++lookups_;
+        const int usernameWidth = usernameLineWidth(username, metrics_);
+        const Key key{message, usernameWidth, hashKey(message, usernameWidth)};
+        const auto it = index_.find(key);
+        if (it != index_.end()) {
+            ++hits_;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->lines;
         }
-        if (!batches.empty() && batches.back().time == msg.time)
-            continue;
-        batches.emplace_back(msg.time, currentLines);
+        size_t &seen = seen_[key.hash % seen_.size()];
+        if (seen != key.hash) {
+            seen = key.hash;
+            wrapLines(usernameWidth, separator_, message, metrics_, uncached_);
+            return uncached_;
+        }
+        if (entries_.size() == capacity_) {
+            index_.erase(entries_.back().key);
+            entries_.pop_back();
+        }
+        Entry &entry = entries_.emplace_front(Entry{std::string(message), key, {}});
+        entry.key.message = entry.message;
+        wrapLines(usernameWidth, separator_, message, metrics_, entry.lines);
+        index_.emplace(entry.key, entries_.begin());
+        return entry.lines;
     }
-    return batches;
-}
 
-inline std::string generateXML(const std::vector<Batch> &batches, const ChatParams &params) {
-    using namespace tinyxml2;
-    XMLDocument doc;
+    size_t lookups() const {
+        return lookups_;
+    }
 
-    std::map<Color, std::string> colors;
-    colors[params.textForegroundColor] = "";
-    // Not optimal, but I want to factor out messages
-    for (const auto &m: batches) {
-        for (const auto &l: m.lines) {
-            if (l.user.has_value())colors[l.user->color] = "";
-        }
-    }
-
-    XMLElement *root = doc.NewElement("timedtext");
-    root->SetAttribute("format", "3");
-    doc.InsertFirstChild(root);
-
-    XMLElement *head = doc.NewElement("head");
-    root->InsertEndChild(head);
-    XMLElement *body = doc.NewElement("body");
-    root->InsertEndChild(body);
-
-    // Create pen elements for each unique color.
-    int penIndex = 0;
-    for (auto &kv: colors) {
-        const Color &color = kv.first;
-        XMLElement *pen = doc.NewElement("pen");
-        pen->SetAttribute("id", std::to_string(penIndex).c_str());
-        pen->SetAttribute("b", (params.textBold ? "1" : "0"));
-        pen->SetAttribute("i", (params.textItalic ? "1" : "0"));
-        pen->SetAttribute("u", (params.textUnderline ? "1" : "0"));
-
-        // Use the friendly textForegroundColor if it differs from default white.
-        pen->SetAttribute("fc", static_cast<std::string>(color).c_str());
-        pen->SetAttribute("fo", std::to_string(params.textForegroundColor.a).c_str());
-        pen->SetAttribute("bc", static_cast<std::string>(params.textBackgroundColor).c_str());
-        pen->SetAttribute("bo", std::to_string(params.textBackgroundColor.a).c_str());
-
-        // Set edge attributes if provided.
-        std::string textEdgeType = enumToIntString(params.textEdgeType);
-        if (!textEdgeType.empty()) {
-            pen->SetAttribute("ec", static_cast<std::string>(params.textEdgeColor).c_str());
-            pen->SetAttribute("et", textEdgeType.c_str());
-        }
-
-        pen->SetAttribute("fs", enumToIntString(params.fontStyle).c_str());
-        pen->SetAttribute("sz", std::to_string(params.fontSizePercent).c_str());
-        head->InsertEndChild(pen);
-        kv.second = std::to_string(penIndex);
-        penIndex++;
-    }
-
-    // Create workspace element for whatever reason.
-    XMLElement *ws = doc.NewElement("ws");
-    ws->SetAttribute("id", "1"); // default workspace id
-    ws->SetAttribute("ju", enumToIntString(params.textAlignment).c_str());
-    head->InsertEndChild(ws);
-
-    // Create window position (wp) elements.
-    for (int i = 0; i < params.totalDisplayLines; ++i) {
-        XMLElement *wp = doc.NewElement("wp");
-        wp->SetAttribute("id", std::to_string(i).c_str());
-        wp->SetAttribute("ap", "0"); // anchor point
-        wp->SetAttribute("ah", std::to_string(params.horizontalMargin).c_str());
-        wp->SetAttribute("av", std::to_string(i * params.verticalSpacing).c_str());
-        head->InsertEndChild(wp);
+    size_t hits() const {
+        return hits_;
     }
-    // Zero-width space (ZWSP) as a UTF-8 string.
-    auto defaultPen = colors[params.textForegroundColor];
-    constexpr const char *ZWSP = "\xE2\x80\x8B";
-    for (size_t batchIndex = 0; batchIndex + 1 < batches.size(); ++batchIndex) {
-        const Batch &batch = batches[batchIndex];
-        const Batch &nextBatch = batches[batchIndex + 1];
-        if (params.verticalSpacing == -1) {
-            XMLElement *pElem = doc.NewElement("p");
-            pElem->SetAttribute("t", std::to_string(batch.time).c_str());
-            int duration = nextBatch.time - batch.time;
-            pElem->SetAttribute("d", std::to_string(duration).c_str());
-            pElem->SetAttribute("wp", "0");
-            pElem->SetAttribute("ws", "1");
-            pElem->SetAttribute("p", defaultPen.c_str());
-            pElem->LinkEndChild(doc.NewText(""));
 
-            for (const auto &[idx, line]: batch.lines | std::ranges::views::enumerate) {
-                if (line.user.has_value()) {
-                    XMLElement *sUser = doc.NewElement("s");
-                    sUser->SetAttribute("p", colors[line.user->color].c_str());
-                    std::string userText = line.user->name;
-                    sUser->SetText(userText.c_str());
-                    pElem->InsertEndChild(sUser);
-                    pElem->LinkEndChild(doc.NewText(ZWSP));
-                }
-                XMLElement *sText = doc.NewElement("s");
-                sText->SetAttribute("p", defaultPen.c_str());
-                sText->SetText(line.text.c_str());
-                pElem->InsertEndChild(sText);
-                pElem->LinkEndChild(doc.NewText("\n"));
+private:
+    struct Key {
+        std::string_view message; // Into the entry
+        int usernameWidth;
+        size_t hash;
+
+        bool operator==(const Key &other) const {
+            return message == other.message && usernameWidth == other.usernameWidth;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return key.hash;
+        }
+    };
+
+    struct Entry {
+        std::string message;
+        Key key;
+        WrappedLines lines;
+    };
+
+    // Mixes the text in eight bytes at a time; every message that misses is hashed, so this
+    // has to be cheaper than std::hash for chat-sized strings.
+    static size_t hashKey(std::string_view message, int usernameWidth) {
+        uint64_t hash = (message.size() + (static_cast<uint64_t>(usernameWidth) << 32)) * 0x9E3779B97F4A7C15;
+        auto mix = [&](uint64_t word) {
+            hash = (hash ^ word) * 0xBF58476D1CE4E5B9;
+            hash ^= hash >> 31;
+        };
+        size_t i = 0;
+        for (; i + 8 <= message.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, message.data() + i, 8);
+            mix(word);
+        }
+        if (i < message.size()) {
+            uint64_t word = 0;
+            std::memcpy(&word, message.data() + i, message.size() - i);
+            mix(word);
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    std::string separator_;
+    LineMetrics metrics_;
+    size_t capacity_;
+    std::list<Entry> entries_; // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    std::vector<size_t> seen_; // Hashes of recently seen keys, by hash
+    WrappedLines uncached_;
+    size_t lookups_ = 0;
+    size_t hits_ = 0;
+};
+
+// Messages generateBatches reads and wraps at a time, per wrapping thread.
+inline constexpr size_t wrapBlockSize = 1 << 13;
+
+// Below this many messages per thread, wrapping a block in parallel is not worth waking threads.
+inline constexpr size_t wrapMinPart = 1 << 10;
+
+// Threads that run the same task on the parts of one block at a time, kept for a whole run so
+// that no thread is started per block.
+class WrapWorkers {
+public:
+    explicit WrapWorkers(size_t count) {
+        for (size_t i = 0; i < count; ++i) threads_.emplace_back([this, i] { run(i); });
+    }
+
+    ~WrapWorkers() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        started_.notify_all();
+    }
+
+    WrapWorkers(const WrapWorkers &) = delete;
+    WrapWorkers &operator=(const WrapWorkers &) = delete;
+
+    // Runs task(i) on worker i for every i < count. The previous round must have been waited for.
+    void start(size_t count, std::function<void(size_t)> task) {
+        {
+            std::lock_guard lock(mutex_);
+            task_ = std::move(task);
+            count_ = count;
+            pending_ = count;
+            ++round_;
+        }
+        started_.notify_all();
+    }
+
+    // Blocks until every task of the round has returned.
+    void wait() {
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    void run(size_t index) {
+        uint64_t seen = 0;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            started_.wait(lock, [&] { return stop_ || round_ != seen; });
+            if (stop_) return;
+            seen = round_;
+            if (index >= count_) continue;
+            lock.unlock();
+            task_(index);
+            lock.lock();
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    std::function<void(size_t)> task_;
+    size_t count_ = 0;
+    size_t pending_ = 0;
+    uint64_t round_ = 0;
+    bool stop_ = false;
+    std::mutex mutex_;
+    std::condition_variable started_;
+    std::condition_variable done_;
+    std::vector<std::jthread> threads_; // Declared last, so they are joined before the rest goes away
+};
+
+// A block of messages on its way through generateBatches: read from the source, then wrapped in
+// parts on several threads, then moved into the window in order.
+struct WrapBlock {
+    struct Message {
+        uint64_t time;
+        uint32_t user;
+        uint32_t length;
+        size_t offset; // Into text
+    };
+
+    // A run of messages wrapped by one thread, into an arena of its own.
+    struct Part {
+        size_t begin = 0;
+        size_t end = 0;
+        std::shared_ptr<TextArena> arena;
+        std::vector<std::string_view> lines; // Into arena
+        std::vector<size_t> ends; // Per message, the end of its lines in 'lines'
+    };
+
+    std::vector<Message> messages;
+    std::string text; // The messages' text, since the source only lends it
+    std::vector<Part> parts;
+};
+
+// Wraps messages pulled from 'source' into the sliding window of chat lines and hands every
+// batch to 'onBatch' as soon as it is complete, so memory stays bounded by the window size.
+// The batch is reused for the next one; 'onBatch' copies what it keeps.
+// 'users' is the table the ids of the source's messages refer to.
+// Messages are read in blocks of wrapBlockSize per thread. With more than one thread (0 = one per
+// hardware thread), each block is wrapped in parts by a WrapWorkers, one part per thread with its
+// own WrapCache, while the window pass of the previous block runs on the calling thread.
+template<typename OnBatch>
+void generateBatches(ChatSource &source, const UserTable &users, const ChatParams &params, OnBatch &&onBatch,
+                     unsigned threads = 1) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::deque<ChatLine> currentLines;
+    std::optional<int> lastTime;
+    // Sources hand out valid UTF-8, so only the separator needs a check.
+    std::string separatorScratch;
+    const std::string separator(utf8Sanitize(params.usernameSeparator, separatorScratch));
+    std::vector<std::unique_ptr<WrapCache> > caches;
+    for (unsigned i = 0; i < threads; ++i)
+        caches.push_back(std::make_unique<WrapCache>(separator, params.lineMetrics()));
+
+    const size_t blockSize = wrapBlockSize * threads;
+    auto read = [&](WrapBlock &block) {
+        block.messages.clear();
+        block.text.clear();
+        ChatMessage msg;
+        while (block.messages.size() < blockSize && source.next(msg)) {
+            block.messages.push_back({msg.time, msg.user, static_cast<uint32_t>(msg.message.size()),
+                                      block.text.size()});
+            block.text += msg.message;
+        }
+    };
+
+    auto wrapPart = [&users](const WrapBlock &block, WrapBlock::Part &part, WrapCache &cache) {
+        for (size_t i = part.begin; i < part.end; ++i) {
+            const WrapBlock::Message &message = block.messages[i];
+            const WrappedLines &lines = cache.wrap(users[message.user].name,
+                                                   std::string_view(block.text).substr(message.offset,
+                                                                                       message.length));
+            const std::string_view text = part.arena->store(lines.text);
+            size_t begin = 0;
+            for (const size_t end: lines.ends) {
+                part.lines.push_back(text.substr(begin, end - begin));
+                begin = end;
             }
-            body->InsertEndChild(pElem);
-        } else {
-            for (const auto &[idx, line]: batch.lines | std::ranges::views::enumerate) {
-                XMLElement *pElem = doc.NewElement("p");
-                pElem->SetAttribute("t", std::to_string(batch.time).c_str());
-                int duration = nextBatch.time - batch.time;
-                pElem->SetAttribute("d", std::to_string(duration).c_str());
-                pElem->SetAttribute("wp", std::to_string(idx).c_str());
-                pElem->SetAttribute("ws", "1");
-                pElem->SetAttribute("p", defaultPen.c_str());
-
-                pElem->LinkEndChild(doc.NewText(""));
-                if (line.user.has_value()) {
-                    XMLElement *sUser = doc.NewElement("s");
-                    sUser->SetAttribute("p", colors[line.user->color].c_str());
-                    std::string userText = line.user->name;
-                    sUser->SetText(userText.c_str());
-                    pElem->InsertEndChild(sUser);
-                    pElem->LinkEndChild(doc.NewText(ZWSP));
-                }
+            part.ends.push_back(part.lines.size());
+        }
+    };
 
-                XMLElement *sText = doc.NewElement("s");
-                sText->SetAttribute("p", defaultPen.c_str());
-                sText->SetText(line.text.c_str());
-                pElem->InsertEndChild(sText);
-                pElem->LinkEndChild(doc.NewText(""));
+    // Starts wrapping a block; it is done once the workers have been waited for.
+    std::optional<WrapWorkers> workers;
+    if (threads > 1) workers.emplace(threads);
+    auto wrap = [&](WrapBlock &block) {
+        const size_t count = std::clamp<size_t>(block.messages.size() / wrapMinPart, 1, threads);
+        block.parts.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            WrapBlock::Part &part = block.parts[i];
+            part.begin = block.messages.size() * i / count;
+            part.end = block.messages.size() * (i + 1) / count;
+            part.arena = std::make_shared<TextArena>(); // The last one may still be in the window
+            part.lines.clear();
+            part.ends.clear();
+        }
+        if (!workers) wrapPart(block, block.parts[0], *caches[0]);
+        else workers->start(count, [&](size_t i) { wrapPart(block, block.parts[i], *caches[i]); });
+    };
+
+    // Arenas the lines of the window point into, oldest first, with how many of them each holds.
+    std::deque<std::pair<std::shared_ptr<const TextArena>, size_t> > windowStorage;
+    auto pushLine = [&](uint32_t user, std::string_view text, const std::shared_ptr<TextArena> &arena) {
+        currentLines.emplace_back(user, text);
+        if (windowStorage.empty() || windowStorage.back().first != arena) windowStorage.emplace_back(arena, 0);
+        ++windowStorage.back().second;
+        if (currentLines.size() > params.totalDisplayLines) {
+            currentLines.pop_front();
+            if (--windowStorage.front().second == 0) windowStorage.pop_front();
+        }
+    };
 
-                body->InsertEndChild(pElem);
+    Batch batch;
+    auto addToWindow = [&](WrapBlock &block) {
+        for (WrapBlock::Part &part: block.parts) {
+            size_t first = 0;
+            for (size_t i = part.begin; i < part.end; ++i) {
+                const WrapBlock::Message &message = block.messages[i];
+                const size_t last = part.ends[i - part.begin];
+                if (first == last)
+                    continue;
+
+                pushLine(message.user, part.lines[first], part.arena);
+                for (size_t k = first + 1; k < last; ++k) pushLine(UserTable::none, part.lines[k], part.arena);
+                first = last;
+                if (lastTime == message.time)
+                    continue;
+                lastTime = message.time;
+                batch.time = static_cast<int>(message.time);
+                batch.lines.assign(currentLines.begin(), currentLines.end());
+                batch.storage.clear();
+                for (const auto &[arena, count]: windowStorage) batch.storage.push_back(arena);
+                onBatch(batch);
             }
         }
+    };
+
+    WrapBlock blocks[2];
+    read(blocks[0]);
+    if (!blocks[0].messages.empty()) wrap(blocks[0]);
+    for (size_t k = 0; !blocks[k % 2].messages.empty(); ++k) {
+        if (workers) workers->wait();
+        WrapBlock &next = blocks[(k + 1) % 2];
+        read(next);
+        if (!next.messages.empty()) wrap(next);
+        addToWindow(blocks[k % 2]);
     }
 
-    XMLPrinter printer;
-    doc.Print(&printer);
-    return printer.CStr();
+    size_t lookups = 0, hits = 0;
+    for (const auto &cache: caches) {
+        lookups += cache->lookups();
+        hits += cache->hits();
+    }
+    if (lookups > 0) {
+        std::cerr << "Note: Reused the wrapping of " << hits << " of " << lookups << " messages (" << hits * 100 / lookups
+                << "% wrap cache hits).\n";
+    }
 }
 
+inline std::vector<Batch> generateBatches(const std::vector<ChatMessage> &messages, const UserTable &users,
+                                          const ChatParams &params) {
+    std::vector<Batch> batches;
+    VectorChatSource source(messages);
+    generateBatches(source, users, params, [&](const Batch &batch) { batches.push_back(batch); });
+    return batches;
+}
 
-inline Color getRandomColor(const std::string &username) {
-    std::vector<Color> defaultColors = {
-        "#ff0000", "#0000ff", "#008000", "#b22222", "#ff7f50",
-        "#9acd32", "#ff4500", "#2e8b57", "#daa520", "#d2691e",
-        "#5f9ea0", "#1e90ff", "#ff69b4", "#8a2be2", "#00ff7f"
-    };
-    std::hash<std::string> hasher;
-    return defaultColors[hasher(username) % defaultColors.size()];
+// Collects the username colors of every message in 'source' plus the text color,
+// i.e. every pen a streamed SRV3 file may need. Rewinds the source afterwards.
+inline std::set<Color> collectColors(ChatSource &source, const UserTable &users, const ChatParams &params) {
+    std::set<Color> colors{params.textForegroundColor};
+    // Colors belong to users, so each user only needs to be looked at once.
+    std::vector<bool> seen(users.size());
+    ChatMessage msg;
+    while (source.next(msg)) {
+        if (msg.user >= seen.size()) seen.resize(users.size());
+        if (seen[msg.user]) continue;
+        seen[msg.user] = true;
+        colors.insert(users[msg.user].color);
+    }
+    source.rewind();
+    return colors;
 }
 
-// dumb and simple way to parse CSV
-inline std::vector<ChatMessage> parseCSV(const std::filesystem::path &filename, int timeMultiplier) {
-    std::vector<ChatMessage> messages;
-    std::ifstream file(filename);
-    std::string line;
+// Writes SRV3 incrementally through a tinyxml2 printer, which can target memory or a FILE*.
+// All pen colors must be known up front because pens live in <head>; batches are written
+// as they arrive, each one once the next batch tells its duration.
+class Srv3Writer {
+public:
+    Srv3Writer(tinyxml2::XMLPrinter &printer, const UserTable &users, const ChatParams &params,
+               const std::set<Color> &colors)
+        : printer_(printer), users_(users), params_(params), metrics_(params.lineMetrics()) {
+        printer_.OpenElement("timedtext");
+        printer_.PushAttribute("format", "3");
+        printer_.OpenElement("head");
+
+        // Create pen elements for each unique color.
+        int penIndex = 0;
+        for (const Color &color: colors) {
+            printer_.OpenElement("pen");
+            printer_.PushAttribute("id", std::to_string(penIndex).c_str());
+            printer_.PushAttribute("b", (params.textBold ? "1" : "0"));
+            printer_.PushAttribute("i", (params.textItalic ? "1" : "0"));
+            printer_.PushAttribute("u", (params.textUnderline ? "1" : "0"));
+
+            // Use the friendly textForegroundColor if it differs from default white.
+            char hex[Color::hexSize + 1];
+            printer_.PushAttribute("fc", terminated(hex, color.formatHex(hex)));
+            printer_.PushAttribute("fo", std::to_string(params.textForegroundColor.a()).c_str());
+            printer_.PushAttribute("bc", terminated(hex, params.textBackgroundColor.formatHex(hex)));
+            printer_.PushAttribute("bo", std::to_string(params.textBackgroundColor.a()).c_str());
+
+            // Set edge attributes if provided.
+            std::string textEdgeType = enumToIntString(params.textEdgeType);
+            if (!textEdgeType.empty()) {
+                printer_.PushAttribute("ec", terminated(hex, params.textEdgeColor.formatHex(hex)));
+                printer_.PushAttribute("et", textEdgeType.c_str());
+            }
+
+            printer_.PushAttribute("fs", enumToIntString(params.fontStyle).c_str());
+            printer_.PushAttribute("sz", std::to_string(params.fontSizePercent).c_str());
+            printer_.CloseElement();
+            pens_[color.rgba] = std::to_string(penIndex);
+            penIndex++;
+        }
 
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << "\n";
-        std::exit(-1);
+        // Create workspace element for whatever reason.
+        printer_.OpenElement("ws");
+        printer_.PushAttribute("id", "1"); // default workspace id
+        printer_.PushAttribute("ju", enumToIntString(params.textAlignment).c_str());
+        printer_.CloseElement();
+
+        // Create window position (wp) elements.
+        for (int i = 0; i < params.totalDisplayLines; ++i) {
+            printer_.OpenElement("wp");
+            printer_.PushAttribute("id", std::to_string(i).c_str());
+            printer_.PushAttribute("ap", "0"); // anchor point
+            printer_.PushAttribute("ah", std::to_string(params.horizontalMargin).c_str());
+            printer_.PushAttribute("av", std::to_string(i * params.verticalSpacing).c_str());
+            printer_.CloseElement();
+        }
+        printer_.CloseElement(); // head
+        printer_.OpenElement("body");
+        defaultPen_ = pens_[params.textForegroundColor.rgba];
     }
 
-    std::getline(file, line);
-    if (line != "time,user_name,user_color,message") {
-        std::cerr << "Error: Unexpected CSV header format.\n";
-        std::exit(-1);
+    // Writes one batch that stays on screen for 'duration' milliseconds.
+    void writeBatch(const Batch &batch, int duration) {
+        const std::string time = std::to_string(batch.time);
+        const std::string d = std::to_string(duration);
+        if (params_.verticalSpacing == -1) {
+            openParagraph(time, d, "0");
+            for (const auto &line: batch.lines) {
+                if (line.hasUser()) writeUser(line.user);
+                writeText(line.text);
+                printer_.PushText("\n");
+            }
+            printer_.CloseElement();
+        } else {
+            for (const auto &[idx, line]: batch.lines | std::ranges::views::enumerate) {
+                openParagraph(time, d, std::to_string(idx).c_str());
+                if (line.hasUser()) writeUser(line.user);
+                writeText(line.text);
+                printer_.PushText("");
+                printer_.CloseElement();
+            }
+        }
     }
 
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string field;
-        ChatMessage msg;
+    // Streaming variant of writeBatch: a batch is written once the next one tells its duration.
+    // The pending copy keeps its buffers from one batch to the next.
+    void addBatch(const Batch &batch) {
+        if (pending_) writeBatch(*pending_, batch.time - pending_->time);
+        pending_ = batch;
+    }
 
-        std::getline(ss, field, ',');
-        msg.time = std::stoi(field) * timeMultiplier;
+    // Closes the document. The last batch has no successor to end it and is dropped.
+    void finish() {
+        printer_.CloseElement(); // body
+        printer_.CloseElement(); // timedtext
+    }
 
-        std::getline(ss, msg.user.name, ',');
+private:
+    void writeUser(uint32_t id) {
+        const User &user = users_[id];
+        printer_.OpenElement("s");
+        printer_.PushAttribute("p", pen(user.color));
+        printer_.PushText(std::string(wrapUsername(user.name, metrics_)).c_str());
+        printer_.CloseElement();
+        printer_.PushText(ZWSP);
+    }
 
-        std::getline(ss, field, ',');
-        msg.user.color = field.empty() ? getRandomColor(msg.user.name) : Color(field);
+    void writeText(std::string_view text) {
+        printer_.OpenElement("s");
+        printer_.PushAttribute("p", defaultPen_.c_str());
+        text_.assign(text); // PushText wants a terminated string
+        printer_.PushText(text_.c_str());
+        printer_.CloseElement();
+    }
 
-        std::getline(ss, msg.message);
+    void openParagraph(const std::string &time, const std::string &duration, const char *wp) {
+        printer_.OpenElement("p");
+        printer_.PushAttribute("t", time.c_str());
+        printer_.PushAttribute("d", duration.c_str());
+        printer_.PushAttribute("wp", wp);
+        printer_.PushAttribute("ws", "1");
+        printer_.PushAttribute("p", defaultPen_.c_str());
+        printer_.PushText("");
+    }
 
-        if (msg.message.size() >= 2 &&
-            msg.message.front() == '"' &&
-            msg.message.back() == '"') {
-            msg.message = msg.message.substr(1, msg.message.size() - 2);
-        }
+    const char *pen(const Color &color) {
+        return pens_[color.rgba].c_str();
+    }
+
+    static const char *terminated(char *begin, char *end) {
+        *end = '\0';
+        return begin;
+    }
 
-        messages.emplace_back(std::move(msg));
+    // Zero-width space (ZWSP) as a UTF-8 string.
+    static constexpr const char *ZWSP = "\xE2\x80\x8B";
+
+    tinyxml2::XMLPrinter &printer_;
+    const UserTable &users_;
+    const ChatParams &params_;
+    const LineMetrics metrics_;
+    std::unordered_map<uint32_t, std::string> pens_; // Packed color -> pen id
+    std::string defaultPen_;
+    std::string text_;
+    std::optional<Batch> pending_;
+};
+
+inline std::string generateXML(const std::vector<Batch> &batches, const UserTable &users, const ChatParams &params) {
+    std::set<Color> colors{params.textForegroundColor};
+    for (const auto &m: batches) {
+        for (const auto &l: m.lines) {
+            if (l.hasUser()) colors.insert(users[l.user].color);
+        }
     }
 
-    return messages;
+    tinyxml2::XMLPrinter printer;
+    Srv3Writer writer(printer, users, params, colors);
+    for (size_t batchIndex = 0; batchIndex + 1 < batches.size(); ++batchIndex)
+        writer.writeBatch(batches[batchIndex], batches[batchIndex + 1].time - batches[batchIndex].time);
+    writer.finish();
+    return printer.CStr();
 }
 
+
 inline float realFontScale(int yttFontSize) {
     return static_cast<float>((100.0 + (yttFontSize - 100.0) / 4.0) / 100.0);
 }
@@ -769,7 +1547,7 @@ static std::string formatTime(uint64_t ms) {
     return std::format("{}:{:02}:{:02}.{:02}", h, m, s, cs);
 }
 
-static std::string escapeText(const std::string &raw) {
+static std::string escapeText(std::string_view raw) {
     std::string out;
     out.reserve(raw.size());
     for (char c: raw) {
@@ -797,6 +1575,7 @@ static std::string escapeText(const std::string &raw) {
 
 
 inline std::string generateAss(const std::vector<Batch> &batches,
+                               const UserTable &users,
                                const ChatParams &chat_params,
                                int video_width, int video_height) {
     static constexpr std::string_view header =
@@ -841,6 +1620,11 @@ inline std::string generateAss(const std::vector<Batch> &batches,
                         : assY(chat_params.verticalMargin + chat_params.verticalSpacing * idx,
                                chat_params.fontSizePercent, video_height);
     }
+    // The text color is the same on every line; user colors are formatted into 'color'.
+    char textColor[Color::assSize];
+    const size_t textColorSize = chat_params.textForegroundColor.formatAss(textColor) - textColor;
+    char color[Color::assSize];
+    const LineMetrics metrics = chat_params.lineMetrics();
 
     for (size_t i = 0; i + 1 < batches.size(); ++i) {
         const auto &curr = batches[i];
@@ -855,11 +1639,12 @@ inline std::string generateAss(const std::vector<Batch> &batches,
                            start, end, posX, posY[idx]
             );
 
-            if (line.user) {
-                ass += line.user->color.toAssColor();
-                ass += escapeText(line.user->name);
+            if (line.hasUser()) {
+                const User &user = users[line.user];
+                ass.append(color, user.color.formatAss(color));
+                ass += escapeText(wrapUsername(user.name, metrics));
             }
-            ass += chat_params.textForegroundColor.toAssColor();
+            ass.append(textColor, textColorSize);
             ass += escapeText(line.text);
             ass += '\n';
         }